@@ -0,0 +1,233 @@
+// Parser throughput benchmark: drives the front end directly (no processes
+// are launched) over a corpus of pathological-but-valid lines at growing
+// sizes, reports tokens/sec and ns/byte, and fails if parse cost per byte
+// stops being flat as the input grows.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "parser.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+// Largest / smallest ns-per-byte ratio tolerated before declaring the
+// scaling non-linear.  Quadratic behaviour over the 8x size range shows up
+// as ~8x, so this leaves plenty of headroom for cache effects and noise.
+#define LINEAR_TOLERANCE 3.0
+#define MIN_SAMPLE_NS 50000000.0 // Keep repeating a size for at least 50 ms
+#define SIZE_STEPS 4             // Each family is measured at 1x, 2x, 4x, 8x
+
+typedef enum
+{
+    API_COMMAND,      // parse_command (validation only)
+    API_REDIRECTION,  // parse_command_with_redirection
+    API_PIPELINE,     // parse_pipeline
+    API_SEQUENTIAL    // parse_sequential_commands
+} parser_api_t;
+
+static const char *api_names[] = {
+    "parse_command",
+    "parse_command_with_redirection",
+    "parse_pipeline",
+    "parse_sequential_commands"};
+
+typedef struct
+{
+    char *buf;
+    size_t len;
+    size_t cap;
+    long tokens;
+} line_builder_t;
+
+static void lb_append(line_builder_t *lb, const char *text, long tokens)
+{
+    size_t n = strlen(text);
+    if (lb->len + n + 1 > lb->cap)
+    {
+        lb->cap = (lb->len + n + 1) * 2;
+        lb->buf = realloc(lb->buf, lb->cap);
+        if (!lb->buf)
+        {
+            perror("bench: realloc failed");
+            exit(2);
+        }
+    }
+    memcpy(lb->buf + lb->len, text, n + 1);
+    lb->len += n;
+    lb->tokens += tokens;
+}
+
+// One corpus family: generate(lb, scale) builds a line roughly
+// proportional to scale bytes
+typedef struct
+{
+    const char *name;
+    long base_scale;
+    void (*generate)(line_builder_t *lb, long scale);
+    parser_api_t apis[4];
+    int api_count;
+} family_t;
+
+// A single command with a huge argument list (1 MB at the top step)
+static void gen_long_args(line_builder_t *lb, long scale)
+{
+    lb_append(lb, "echo", 1);
+    while ((long)lb->len < scale)
+        lb_append(lb, " argument_value", 1);
+}
+
+// a | b | c ... with thousands of stages (10,000 at the top step)
+static void gen_pipeline(line_builder_t *lb, long scale)
+{
+    lb_append(lb, "cat input.txt", 2);
+    for (long i = 1; i < scale; i++)
+        lb_append(lb, " | grep -v x", 4);
+    lb_append(lb, " &", 1); // trailing & must not cost a copy of the line
+}
+
+// Thousands of ; and & separated groups
+static void gen_sequential(line_builder_t *lb, long scale)
+{
+    lb_append(lb, "echo start", 2);
+    for (long i = 1; i < scale; i++)
+        lb_append(lb, (i % 4) ? " ; echo step" : " & sleep 0", 3);
+}
+
+// One command carrying many redirections
+static void gen_redirections(line_builder_t *lb, long scale)
+{
+    lb_append(lb, "sort", 1);
+    for (long i = 0; i < scale; i++)
+        lb_append(lb, " < in.txt > out.txt >> log.txt -r", 7);
+}
+
+static const family_t families[] = {
+    {"long-args", 128 * 1024, gen_long_args,
+     {API_COMMAND, API_REDIRECTION, API_PIPELINE, API_SEQUENTIAL}, 4},
+    {"pipeline", 1250, gen_pipeline,
+     {API_COMMAND, API_PIPELINE, API_SEQUENTIAL}, 3},
+    {"sequential", 1000, gen_sequential,
+     {API_COMMAND, API_SEQUENTIAL}, 2},
+    {"redirections", 1000, gen_redirections,
+     {API_COMMAND, API_REDIRECTION, API_PIPELINE, API_SEQUENTIAL}, 4},
+};
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int run_once(parser_api_t api, const char *line, arena_t *arena)
+{
+    parsed_command_t cmd;
+    command_pipeline_t pipeline;
+    sequential_commands_t seq_cmds;
+    int result = -1;
+
+    switch (api)
+    {
+    case API_COMMAND:
+        result = parse_command(line);
+        break;
+    case API_REDIRECTION:
+        result = parse_command_with_redirection(line, &cmd, arena);
+        break;
+    case API_PIPELINE:
+        result = parse_pipeline(line, &pipeline, arena);
+        break;
+    case API_SEQUENTIAL:
+        result = parse_sequential_commands(line, &seq_cmds, arena);
+        break;
+    }
+    arena_reset(arena);
+    return result;
+}
+
+// Best-of-N time for one parse of line, in nanoseconds
+static double time_parse(parser_api_t api, const char *line, arena_t *arena)
+{
+    double best = -1, total = 0;
+
+    while (total < MIN_SAMPLE_NS)
+    {
+        double start = now_ns();
+        if (run_once(api, line, arena) != 0)
+        {
+            fprintf(stderr, "bench: %s rejected a valid corpus line\n", api_names[api]);
+            exit(2);
+        }
+        double elapsed = now_ns() - start;
+        total += elapsed;
+        if (best < 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+int main(void)
+{
+    arena_t arena;
+    int failures = 0;
+
+    arena_init(&arena);
+
+    printf("%-13s %-31s %10s %9s %12s %9s\n",
+           "family", "api", "bytes", "ms", "Mtokens/s", "ns/byte");
+
+    for (size_t f = 0; f < sizeof(families) / sizeof(families[0]); f++)
+    {
+        const family_t *fam = &families[f];
+        line_builder_t lines[SIZE_STEPS];
+
+        for (int step = 0; step < SIZE_STEPS; step++)
+        {
+            memset(&lines[step], 0, sizeof(lines[step]));
+            fam->generate(&lines[step], fam->base_scale << step);
+        }
+
+        for (int a = 0; a < fam->api_count; a++)
+        {
+            parser_api_t api = fam->apis[a];
+            double first_ns_per_byte = 0, last_ns_per_byte = 0;
+
+            for (int step = 0; step < SIZE_STEPS; step++)
+            {
+                double ns = time_parse(api, lines[step].buf, &arena);
+                double ns_per_byte = ns / lines[step].len;
+
+                printf("%-13s %-31s %10zu %9.3f %12.2f %9.3f\n",
+                       fam->name, api_names[api], lines[step].len, ns / 1e6,
+                       lines[step].tokens / ns * 1e3, ns_per_byte);
+
+                if (step == 0)
+                    first_ns_per_byte = ns_per_byte;
+                last_ns_per_byte = ns_per_byte;
+            }
+
+            double ratio = last_ns_per_byte / first_ns_per_byte;
+            if (ratio > LINEAR_TOLERANCE)
+            {
+                printf("FAIL: %s/%s ns/byte grew %.2fx over a %dx size range\n",
+                       fam->name, api_names[api], ratio, 1 << (SIZE_STEPS - 1));
+                failures++;
+            }
+        }
+
+        for (int step = 0; step < SIZE_STEPS; step++)
+            free(lines[step].buf);
+    }
+
+    arena_destroy(&arena);
+
+    if (failures)
+    {
+        printf("%d scaling check(s) failed\n", failures);
+        return 1;
+    }
+    printf("parser cost scales linearly with input size\n");
+    return 0;
+}
+
+/* ############## LLM Generated Code Ends ################ */
@@ -0,0 +1,36 @@
+#ifndef ARENA_H
+#define ARENA_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <stddef.h>
+
+// Bump allocator for memory that lives exactly as long as one input line.
+// Chunks are kept across resets, so after warm-up a line costs no malloc
+// calls at all and releasing everything is a single pointer reset.
+
+#define ARENA_CHUNK_SIZE 4096
+#define ARENA_ALIGN 16
+
+typedef struct arena_chunk
+{
+    struct arena_chunk *next;
+    size_t size;          // Usable bytes in data
+    size_t used;          // Bytes handed out since the last reset
+    unsigned char *data;
+} arena_chunk_t;
+
+typedef struct
+{
+    arena_chunk_t *first;   // Head of the retained chunk list
+    arena_chunk_t *current; // Chunk currently being carved up
+} arena_t;
+
+void arena_init(arena_t *arena);
+void *arena_alloc(arena_t *arena, size_t size);
+void *arena_realloc(arena_t *arena, void *ptr, size_t old_size, size_t new_size);
+char *arena_strdup(arena_t *arena, const char *str);
+void arena_reset(arena_t *arena);   // O(1); memory is reused, not freed
+void arena_destroy(arena_t *arena); // Releases every chunk
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
@@ -0,0 +1,51 @@
+#ifndef BUILTINS_H
+#define BUILTINS_H
+/* ############## LLM Generated Code Begins ############## */
+
+// Builtin registry.  The table is laid out at compile time by a perfect
+// hash of the name, so a lookup is one hash, one strcmp and no search; the
+// handler gets the parsed words as argc/argv without re-splitting.
+
+typedef int (*builtin_fn_t)(int argc, char **argv);
+
+#define BUILTIN_TABLE_SIZE 16
+
+// Flags: whether the builtin may run in a forked pipeline stage, i.e. it
+// only reads shell state
+#define BUILTIN_FORKABLE 0x1        // Always
+#define BUILTIN_FORKABLE_BARE 0x2   // Only when given no arguments
+
+typedef struct
+{
+    const char *name;
+    builtin_fn_t fn;
+    int flags;
+} builtin_t;
+
+// Registry entry for name, or NULL if it is not a builtin
+const builtin_t *builtin_lookup(const char *name);
+
+// Whether b may run in a child with argc words (argv[0] included)
+int builtin_forkable(const builtin_t *b, int argc);
+
+// Prefix words (time, profile, memo) modify the pipeline that follows
+// them instead of running as a command.  They have a table of their own,
+// laid out the same way; the handler gets the whole pipeline, its own
+// word still first.
+
+struct command_pipeline;
+typedef int (*prefix_fn_t)(struct command_pipeline *pipeline);
+
+#define PREFIX_TABLE_SIZE 8
+
+typedef struct
+{
+    const char *name;
+    prefix_fn_t fn;
+} prefix_t;
+
+// Prefix table entry for name, or NULL if it is not a prefix word
+const prefix_t *prefix_lookup(const char *name);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
@@ -6,28 +6,26 @@
 
 // Command execution function
 int execute_command(const char *input);
-int execute_reveal(char *args);
-int execute_log(char *args);
 
-// Direct execution functions for redirection
-int execute_hop_direct(char *args);
+// Builtin handlers (dispatched through the registry in builtins.c);
+// argv[0] is the builtin's own name
+int execute_hop(int argc, char **argv);
+int execute_reveal(int argc, char **argv);
+int execute_log(int argc, char **argv);
 
 // Activities command
-int execute_activities(void);
+int execute_activities(int argc, char **argv);
 
 // Ping command
-int execute_ping(char *args);
-// Add this line to commands.h
-// void handle_pending_signals(void);
+int execute_ping(int argc, char **argv);
 
+// hash command (PATH lookup cache)
+int execute_hash(int argc, char **argv);
 
 // fg and bg command functions
-int execute_fg(char *args);
-int execute_bg(char *args);
+int execute_fg(int argc, char **argv);
+int execute_bg(int argc, char **argv);
 
-// Helper functions for job management
-background_job_t* find_job_by_id(int job_id);
-background_job_t* find_most_recent_job(void);
 
 
 #endif
@@ -0,0 +1,65 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <sys/types.h>
+#include "usage.h"
+
+// Event loop.  One epoll set watches the input fd, a signalfd for SIGCHLD,
+// SIGINT and SIGTSTP (blocked for the whole shell, so there are no signal
+// handlers at all) and a pidfd per watched child.  A job's exit is seen
+// the moment its pidfd becomes readable and is dispatched in O(1) through
+// a pid-keyed table; stops and continues come from SIGCHLD.
+
+#define EVENTS_WATCH_BUCKETS 64
+#define EVENTS_MAX_BATCH 32
+
+// Block the signals, create the epoll set and the signalfd.  input_fd need
+// not be pollable (a script file); input is then treated as always ready.
+int events_init(int input_fd);
+
+// Handle everything already pending without blocking
+void events_poll(void);
+
+// Block until input_fd is readable, handling job events meanwhile.  In
+// interactive mode a notification is followed by a fresh prompt.  Returns
+// 1 early if Ctrl-C arrived first (the terminal has then dropped the
+// partly typed line), 0 once input is ready.
+int events_wait_input(void);
+
+// Watch a background job's process: its exit, stop and continue are
+// reported through job_exited / job_stopped / job_continued
+int events_watch_job(pid_t pid);
+
+// Watch a process only to reap it (non-leader members of background
+// pipelines); its resource usage is added to the job led by owner
+int events_watch_quiet(pid_t pid, pid_t owner);
+
+// Stop watching pid; the caller takes over waiting for it
+void events_unwatch(pid_t pid);
+
+// Wait for the foreground processes pids[0..count) (entries <= 0 are
+// skipped) to finish, forwarding Ctrl-C/Ctrl-Z to g_foreground_pgid.
+// statuses[i] gets each wait status, or -1 if it never finished, and the
+// resource usage of every process reaped is added to usage (if not NULL).
+// Returns 1 if the group was stopped (it is then a job, carrying usage),
+// 0 otherwise.
+int events_wait_foreground(const pid_t *pids, int *statuses, int count, job_usage_t *usage);
+
+// Wait until at least one of the running processes pids[i] (those with
+// pids[i] > 0 and statuses[i] == -1) finishes; its status is stored in
+// statuses[i].  Returns 1 early if Ctrl-C arrived, 0 otherwise.  The
+// processes still running stay watched for the next call, so nothing else
+// may run the loop in between.
+int events_wait_any(const pid_t *pids, int *statuses, int count);
+
+// Call tick(arg) every interval_ms while the loop waits, until replaced;
+// tick NULL removes it.  Used by profile to sample a running pipeline.
+int events_set_ticker(void (*tick)(void *arg), void *arg, int interval_ms);
+
+// In a forked child: drop the parent's epoll set, signalfd and watches.  A
+// loop of the child's own is set up when it first waits for a process.
+void events_reset_child(int input_fd);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
@@ -0,0 +1,37 @@
+#ifndef FANOUT_H
+#define FANOUT_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <sys/types.h>
+
+// Several output redirections on one command (cmd > a > b >> c).  The
+// command writes into a pipe and a relay process duplicates the pipe's
+// pages into one more pipe per extra target with tee(2), then moves each
+// pipe's contents into its file with splice(2).  The data is never copied
+// through user space, except into targets that cannot take a splice
+// (a terminal), which fall back to read/write.
+
+typedef struct
+{
+    int *fds;       // One per target, close-on-exec
+    int count;
+} fanout_t;
+
+// Open every target (appends[i]: >> instead of >, count >= 2) with the
+// shell's error message; 0 on success, -1 (nothing left open) otherwise
+int fanout_open(fanout_t *f, char *const *files, const int *appends, int count);
+
+void fanout_close(fanout_t *f);
+
+// Copy everything read from read_fd (a pipe) into every target until EOF.
+// Runs in a child: all other descriptors above stderr are closed first.
+// If the tee pipes cannot be set up the data is still copied, by
+// read/write, and -1 is returned so the relay can exit with a failure.
+int fanout_relay(int read_fd, const fanout_t *f);
+
+// Fork a relay reading from a new pipe and close the targets; returns the
+// pipe's write end (close-on-exec) and the relay's pid in *pid, or -1
+int fanout_start(fanout_t *f, pid_t *pid);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
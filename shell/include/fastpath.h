@@ -0,0 +1,31 @@
+#ifndef FASTPATH_H
+#define FASTPATH_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include "builtins.h"
+
+// In-process versions of cat, head -n and wc -l/-c/-w.  They take the
+// place of the binaries when given only the options they implement and
+// otherwise step aside, so the real cat/head/wc still run for anything
+// else.  cat copies in the kernel (copy_file_range, splice, sendfile);
+// wc counts newlines and word starts with a vectorized kernel (AVX2, SSE2
+// or scalar, picked at first use).  Output matches GNU coreutils.
+//
+// SHELL_FASTPATH=off in the environment disables them;
+// SHELL_FASTPATH=scalar|sse2|avx2 forces the counting kernel.
+
+// The fast path for name run with args[0..arg_count), or NULL if there is
+// none or an option is one only the real binary has.  The entry is used
+// like a builtin (argc/argv, exit status 0 or 1).
+const builtin_t *fastpath_lookup(const char *name, char **args, int arg_count);
+
+// Whether every file operand in args is a regular file (or missing, which
+// is reported without reading); *reads_stdin is set if standard input is
+// read as well
+int fastpath_inputs_regular(const char *name, char **args, int arg_count, int *reads_stdin);
+
+// Name of the counting kernel in use: "avx2", "sse2" or "scalar"
+const char *fastpath_impl_name(void);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
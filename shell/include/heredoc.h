@@ -0,0 +1,36 @@
+#ifndef HEREDOC_H
+#define HEREDOC_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include "parser.h"
+#include "input.h"
+
+// Here-documents (<<DELIM) and here-strings (<<<word).  A body is handed
+// to the command as a sealed memfd: an anonymous in-memory file that
+// nobody can modify, so there is no temp file to create or clean up and
+// no writer process.  Bodies live in the line arena; the parse tree only
+// numbers them, so it can still be cached.
+
+#define HEREDOC_INTERRUPTED (-2)
+
+// Read the body of every here-document of seq_cmds from the lines that
+// follow on reader, each up to its delimiter line (prompted with "> "
+// when interactive).  Must be called for every line, even one without
+// here-documents.  Returns -1 if input ended before a delimiter; the
+// body read so far is kept.  Returns HEREDOC_INTERRUPTED if Ctrl-C was
+// pressed at a "> " prompt; the line should then not run.
+int heredoc_collect(const sequential_commands_t *seq_cmds, line_reader_t *reader);
+
+// Mark seq_cmds as the tree being executed until the matching
+// heredoc_leave (given what heredoc_enter returned).  The bodies read by
+// heredoc_collect only serve the tree they were read for; a line replayed
+// while it runs (log execute, a parallel runner) gets empty input.
+const sequential_commands_t *heredoc_enter(const sequential_commands_t *seq_cmds);
+void heredoc_leave(const sequential_commands_t *previous);
+
+// Body of cmd's here-document or here-string as a sealed memfd at offset
+// 0 (close-on-exec), or -1 after printing the error
+int heredoc_open(const parsed_command_t *cmd);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
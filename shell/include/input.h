@@ -0,0 +1,34 @@
+#ifndef INPUT_H
+#define INPUT_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <sys/types.h>
+
+// Line reader over a raw file descriptor with one reusable buffer.  Lines
+// are handed out in place (newline replaced by '\0') and stay valid until
+// the next call, so reading a line costs no allocation.
+
+#define INPUT_BUFFER_SIZE (64 * 1024)
+
+typedef struct
+{
+    int fd;
+    char *buf;
+    size_t cap;   // Bytes allocated for buf
+    size_t start; // First unconsumed byte
+    size_t len;   // Bytes read into buf
+    int eof;      // read() returned 0
+} line_reader_t;
+
+int reader_init(line_reader_t *reader, int fd, size_t cap);
+void reader_destroy(line_reader_t *reader);
+
+// Next line without its trailing newline.  Returns the line length, or -1
+// at end of input, or -2 on a read error (errno is set; EINTR included).
+ssize_t reader_next_line(line_reader_t *reader, char **line);
+
+// 1 if a complete line (or the final unterminated one) is already buffered
+int reader_has_line(const line_reader_t *reader);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
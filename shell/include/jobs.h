@@ -0,0 +1,35 @@
+#ifndef JOBS_H
+#define JOBS_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include "shell.h"
+
+// Job table.  Jobs are allocated individually and indexed four ways: hash
+// chains by pid and by job id, a list in job-id order (the tail is the most
+// recent job) and an array kept sorted by command for activities.  The
+// hash tables double when the load factor reaches 1, so there is no limit
+// on the number of live jobs.
+
+#define JOBS_INITIAL_BUCKETS 64
+
+// Create a running job with the next job id; NULL if out of memory
+background_job_t *jobs_add(pid_t pid, const char *command);
+
+// Unlink job from every index and free it
+void jobs_remove(background_job_t *job);
+
+// Any job whose process is pid, including one taken to the foreground
+background_job_t *jobs_find_pid(pid_t pid);
+
+// Active jobs only
+background_job_t *jobs_find_id(int job_id);
+background_job_t *jobs_most_recent(void);
+
+// All jobs in job-id order, for walking with ->next
+background_job_t *jobs_first(void);
+
+// All jobs sorted by command (ties by job id); *count gets the length
+background_job_t *const *jobs_by_command(int *count);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
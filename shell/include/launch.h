@@ -0,0 +1,53 @@
+#ifndef LAUNCH_H
+#define LAUNCH_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <sys/types.h>
+
+// Process launch layer.  Every external command goes through
+// launch_process, which hands it to the fork server (zygote.h) or, without
+// one, uses posix_spawn (a vfork-style clone in glibc), so launch cost
+// does not grow with the shell's own address space.
+// Redirection files are opened in the parent and wired in with spawn file
+// actions together with the pipe ends and the process group.
+
+#define LAUNCH_NEW_GROUP 0  // pgid: child leads a new process group
+#define LAUNCH_SAME_GROUP -1 // pgid: child stays in the shell's group
+
+typedef struct
+{
+    char **argv;             // NULL-terminated; argv[0] is resolved via the path cache
+    int stdin_fd;            // Becomes the child's stdin (-1: inherit)
+    int stdout_fd;           // Becomes the child's stdout (-1: inherit)
+    const char *input_file;  // < file, applied after stdin_fd
+    const char *output_file; // > or >> file, applied after stdout_fd
+    int append_mode;         // 1 if >>, 0 if >
+    char **outputs;          // With output_count > 1: every target of a
+    const int *output_appends; // fan-out (output_file is then ignored)
+    int output_count;
+    const int *keep_fds;     // Passed on at the same numbers (the /dev/fd
+    int keep_count;          // paths of process substitutions)
+    pid_t pgid;              // LAUNCH_NEW_GROUP, LAUNCH_SAME_GROUP or a group to join
+} launch_spec_t;
+
+// Start the process described by spec.  Returns its pid, or -1 after
+// printing the reason (redirection failure or "Command not found!").
+// With several outputs the pid is a small host process in the same group
+// that spawns the command into a pipe, relays its output to every target
+// (fanout.h) and exits with the command's status, so callers wait for
+// and job-control one process either way.
+// Descriptors other than 0-2 are not inherited unless listed in the spec,
+// so callers should create pipes with O_CLOEXEC.
+pid_t launch_process(const launch_spec_t *spec);
+
+// Open redirection targets with the shell's error messages; return the fd
+// (close-on-exec) or -1
+int launch_open_input(const char *filename);
+int launch_open_output(const char *filename, int append_mode);
+
+// In a forked helper that does not exec (a relay): close every descriptor
+// above stderr except the count in keep, which is sorted in place
+void launch_close_others(int *keep, int count);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
@@ -0,0 +1,62 @@
+#ifndef MEMO_H
+#define MEMO_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <sys/types.h>
+#include "parser.h"
+
+// `memo cmd`: content-addressed cache of a command's output.  The key is
+// argv, the cwd, the environment, the here-document body and the device,
+// inode, size and mtime of the resolved binary, the < file and every
+// argument that names an existing file.  On a hit the stored stdout,
+// stderr and exit status are replayed without running anything.  On a
+// miss the command runs through the normal redirection path with stdout
+// and stderr on pipes to a relay process, which passes each write on to
+// where it was going as it arrives and logs it; the log is stored unless
+// the command was stopped or killed.  Replay keeps the order of the
+// writes across the two streams.  As in `cmd 2>&1 | tee`, the command
+// sees pipes rather than a terminal, and what it prints then is what is
+// cached.  Entries are files named by the key's hash under MEMO_DIRNAME
+// in the shell's home, and carry the whole key, so a hash collision is
+// only a miss.  Standard input is not part of the key.
+
+#define MEMO_DIRNAME ".shell_memo"
+
+typedef struct
+{
+    char *data;                 // Key text, in the line arena
+    size_t len;
+    size_t cap;
+    uint64_t hash;
+    char path[PATH_MAX + 64];   // The entry's file
+} memo_key_t;
+
+// Build cmd's key; -1 if cmd cannot be memoized (process substitutions)
+int memo_key(const parsed_command_t *cmd, memo_key_t *key);
+
+// On a hit, write the stored output where cmd's redirections send it,
+// set *status and return 1; 0 on a miss
+int memo_replay(const memo_key_t *key, const parsed_command_t *cmd, int *status);
+
+typedef struct
+{
+    pid_t relay;
+    int out_fd;     // Write ends for the command's stdout and stderr
+    int err_fd;
+    int log_fd;     // memfd the relay logs the output to
+} memo_capture_t;
+
+// Open cmd's output targets and start the relay; -1 after the error
+// (cmd should then not run, as when a target cannot be opened)
+int memo_capture_start(const parsed_command_t *cmd, memo_capture_t *cap);
+
+// Once the command has returned: close the write ends and, if keep, wait
+// for the relay and store the log with status under key.  Otherwise the
+// relay is left to forward what a stopped command still writes.
+void memo_capture_finish(memo_capture_t *cap, const memo_key_t *key, int status, int keep);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
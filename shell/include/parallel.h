@@ -0,0 +1,31 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+/* ############## LLM Generated Code Begins ############## */
+
+// parallel [-j N] [-u] [file]: run the command lines of file (or stdin)
+// with at most N running at once, starting the next as each finishes.
+// Each line runs in a forked copy of the shell, so it may itself be a
+// pipeline or a ';' / '&' sequence.  Output is held per line and written
+// in input order, each line's stdout to stdout and then its stderr to
+// stderr; with -u both are passed through as the lines produce them.
+
+// Runners with no -j: one per online CPU
+#define PARALLEL_DEFAULT_JOBS 0
+
+int execute_parallel(int argc, char **argv);
+
+// par [-u] N cmd [args]: a data-parallel pipeline stage.  Standard input
+// is cut on line boundaries into blocks of about PAR_BLOCK_SIZE bytes and
+// each block is piped through its own copy of cmd, at most N at once, so
+// a CPU-bound filter (grep, a parser) uses N cores.  Output is held per
+// block and written in input order; with -u in the order the copies
+// finish, lines still whole.  Only stdout is captured: the copies' stderr
+// goes straight to the shell's.  A block is also cut early when the input
+// goes idle, so a slow stream is not held back.
+#define PAR_BLOCK_SIZE (1 << 20)
+#define PAR_IDLE_MS 50
+
+int execute_par(int argc, char **argv);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
@@ -0,0 +1,24 @@
+#ifndef PARSE_CACHE_H
+#define PARSE_CACHE_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include "parser.h"
+
+// Bounded cache of parsed command lines, keyed by a hash of the line text.
+// Replaying a line (log execute, scripted loops) hands back the stored
+// sequential_commands_t instead of parsing it again.
+
+#define PARSE_CACHE_SETS 16
+#define PARSE_CACHE_WAYS 4
+
+// Look up (or parse and insert) a line.  Returns NULL on invalid syntax.
+// The tree is shared and must not be modified; it stays valid until the
+// matching parse_cache_release, even across nested lookups.
+sequential_commands_t *parse_cache_acquire(const char *line);
+void parse_cache_release(sequential_commands_t *seq_cmds);
+
+void parse_cache_stats(unsigned long *hits, unsigned long *misses, int *entries);
+void parse_cache_clear(void);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
@@ -2,18 +2,37 @@
 #define PARSER_H
 /* ############## LLM Generated Code Begins ############## */
 
+#include "arena.h"
+
+struct command_pipeline;
+
+// Process substitution: <(pipeline) or >(pipeline) as an argument
+typedef struct {
+    int arg_index;           // Slot in args that becomes its /dev/fd path
+    int is_output;           // 1 for >(...): the command writes into it
+    struct command_pipeline *pipeline; // Runs alongside the command
+} proc_sub_t;
+
 // Structure to hold parsed command information
 typedef struct {
     char *command;           // The main command
     char **args;            // Command arguments  
     int arg_count;          // Number of arguments
     char *input_file;       // Input redirection file (< file)
+    char *here_doc;         // <<DELIM: the delimiter; the body comes from
+    int here_index;         // the lines after this one (heredoc.h), 1-based
+    char *here_string;      // <<<word: the word plus a newline
     char *output_file;      // Output redirection file (> file or >> file)
     int append_mode;        // 1 if >>, 0 if >
+    char **outputs;         // Every > / >> target in order; output_file is the last
+    int *output_appends;    // append_mode of each
+    int output_count;       // More than 1: the output is fanned out to all
+    proc_sub_t *proc_subs;  // Process substitutions among args
+    int proc_sub_count;
 } parsed_command_t;
 
 // Structure for pipe handling
-typedef struct {
+typedef struct command_pipeline {
     parsed_command_t *commands;  // Array of commands in pipeline
     int cmd_count;              // Number of commands in pipeline
     int is_background;          // 1 if pipeline should run in background
@@ -23,15 +42,15 @@ typedef struct {
 typedef struct {
     command_pipeline_t *pipelines;  // Array of command pipelines
     int pipeline_count;             // Number of pipelines to execute sequentially
+    char **here_docs;               // Delimiters of the line's here-documents
+    int here_doc_count;
 } sequential_commands_t;
 
-// Parser function declarations
+// Parser function declarations.  Every node, array and string of a parse
+// is carved out of the given arena and released together when it is reset.
 int parse_command(const char *input);
-int parse_command_with_redirection(const char *input, parsed_command_t *cmd);
-int parse_pipeline(const char *input, command_pipeline_t *pipeline);
-int parse_sequential_commands(const char *input, sequential_commands_t *seq_cmds);
-void cleanup_parsed_command(parsed_command_t *cmd);
-void cleanup_pipeline(command_pipeline_t *pipeline);
-void cleanup_sequential_commands(sequential_commands_t *seq_cmds);
+int parse_command_with_redirection(const char *input, parsed_command_t *cmd, arena_t *arena);
+int parse_pipeline(const char *input, command_pipeline_t *pipeline, arena_t *arena);
+int parse_sequential_commands(const char *input, sequential_commands_t *seq_cmds, arena_t *arena);
 /* ############## LLM Generated Code Ends ################ */
 #endif
\ No newline at end of file
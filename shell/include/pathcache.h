@@ -0,0 +1,30 @@
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+/* ############## LLM Generated Code Begins ############## */
+
+// Resolved-path cache for command names, so a launch does not walk PATH
+// with one failed execve per directory.  Misses are cached too; they are
+// re-checked against the PATH directories' mtimes at most once per
+// PATH_CACHE_RECHECK_MS.  The whole table is dropped when PATH changes,
+// and a cached binary that has disappeared is forgotten by the launcher.
+
+#define PATH_CACHE_BUCKETS 64
+#define PATH_CACHE_RECHECK_MS 1000
+
+// Full path for name, or NULL if it is not an executable in PATH.  Names
+// containing '/' are returned unchanged.  The string stays valid until the
+// next call into the cache.
+const char *path_cache_lookup(const char *name);
+
+// Search PATH again for name and cache the result (hash name); returns 0
+// if found, -1 otherwise
+int path_cache_add(const char *name);
+
+void path_cache_forget(const char *name);
+void path_cache_clear(void);
+
+// List the cached hits as "hits<TAB>path" (hash with no arguments)
+void path_cache_print(void);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
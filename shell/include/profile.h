@@ -0,0 +1,29 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <sys/types.h>
+#include "parser.h"
+
+// `profile pipeline`: run the pipeline while sampling every stage every
+// PROFILE_INTERVAL_MS from the event loop's ticker.  A sample reads the
+// stage's state and CPU time from /proc/<pid>/stat, its bytes read and
+// written from /proc/<pid>/io, and the fill level of the pipes around it
+// with FIONREAD.  A sleeping stage whose input pipe is empty is blocked on
+// input; one whose output pipe is full is blocked on output.  The stage
+// that is blocked on neither for longest is the bottleneck.  The report
+// goes to stderr like time's.
+
+#define PROFILE_INTERVAL_MS 10
+
+typedef struct profile profile_t;
+
+// Start sampling the stages of a pipeline just launched: pids[i] runs
+// commands[i] (pids[i] <= 0: it ran in the shell and is not sampled)
+profile_t *profile_start(const pid_t *pids, const parsed_command_t *commands, int count);
+
+// Stop sampling and print the per-stage report
+void profile_finish(profile_t *p);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
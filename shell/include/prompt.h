@@ -4,5 +4,6 @@
 /* ############## LLM Generated Code Begins ############## */
 int prompt_init(void); // set shell "home" + cache ids
 int prompt_build(char *buf, size_t buflen); // builds "<user@host:path> "
+void prompt_invalidate(void); // cwd changed; rebuild the cached prompt
 /* ############## LLM Generated Code Ends ################ */
 #endif
\ No newline at end of file
@@ -13,6 +13,12 @@ int execute_pipeline(command_pipeline_t *pipeline);
 // Function to execute sequential commands
 int execute_sequential_commands(sequential_commands_t *seq_cmds);
 
+// Prefix words (builtins.h): time, profile and memo, each given the whole
+// pipeline with its own word first
+int execute_timed_pipeline(command_pipeline_t *pipeline);
+int execute_profiled_pipeline(command_pipeline_t *pipeline);
+int execute_memoized_pipeline(command_pipeline_t *pipeline);
+
 // Function to execute command in background
 int execute_command_background(parsed_command_t *cmd);
 
@@ -0,0 +1,70 @@
+#ifndef SCAN_H
+#define SCAN_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <stdint.h>
+
+// Token-boundary scanning for the lexer.  The line is classified 64 bytes
+// at a time into two bitmaps (whitespace, and "cannot be part of a name":
+// NUL, whitespace or | & > < ;) and the lexer walks the set bits, so each
+// byte is classified once no matter how short the tokens are.
+//
+// The classifier (AVX2, SSE2 or scalar) is picked once at runtime on first
+// use; SHELL_SCAN=scalar|sse2|avx2 in the environment overrides it.
+
+#define SCAN_WINDOW 64
+
+typedef struct
+{
+    const char *window; // Start of the classified window
+    const char *end;    // Terminating NUL of the line
+    int len;            // Bytes of the window that are classified
+    uint64_t space;     // Bit i set: window[i] is whitespace
+    uint64_t stop;      // Bit i set: window[i] ends a name
+} scan_cursor_t;
+
+void scan_cursor_init(scan_cursor_t *cur, const char *buf, const char *end);
+
+// Classify the window starting at p (out of line; dispatches on the CPU)
+void scan_classify_window(scan_cursor_t *cur, const char *p);
+
+// Walk the bitmaps for the first byte at or after p that is set in the stop
+// bitmap (want_stop) or clear in the space bitmap.  Inline so the per-token
+// cost in the lexer is a shift and a count-trailing-zeros.
+static inline const char *scan_find(scan_cursor_t *cur, const char *p, int want_stop)
+{
+    while (p < cur->end)
+    {
+        if (p < cur->window || p >= cur->window + cur->len)
+            scan_classify_window(cur, p);
+
+        int offset = (int)(p - cur->window);
+        uint64_t bits = (want_stop ? cur->stop : ~cur->space) >> offset;
+        int remaining = cur->len - offset;
+        if (remaining < 64)
+            bits &= ((uint64_t)1 << remaining) - 1;
+
+        if (bits)
+            return p + __builtin_ctzll(bits);
+        p = cur->window + cur->len;
+    }
+    return cur->end;
+}
+
+// First byte at or after p that is not whitespace (end if none)
+static inline const char *scan_skip_whitespace(scan_cursor_t *cur, const char *p)
+{
+    return scan_find(cur, p, 0);
+}
+
+// First byte at or after p that cannot be part of a name (end if none)
+static inline const char *scan_word_end(scan_cursor_t *cur, const char *p)
+{
+    return scan_find(cur, p, 1);
+}
+
+// Name of the classifier in use ("avx2", "sse2" or "scalar")
+const char *scan_impl_name(void);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
@@ -9,6 +9,8 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <signal.h>
+#include "arena.h"
+#include "usage.h"
 
 /* Ensure PATH_MAX is defined */
 #ifndef PATH_MAX
@@ -43,9 +45,7 @@ extern char g_log_commands[MAX_LOG_COMMANDS][1024];
 extern int g_log_count;
 extern int g_log_start;
 
-// Background job management
-#define MAX_BACKGROUND_JOBS 100
-
+// Background job management (table and indexes in jobs.c)
 typedef enum {
     PROCESS_RUNNING,
     PROCESS_STOPPED,
@@ -56,13 +56,15 @@ typedef struct background_job {
     int job_id;
     pid_t pid;
     char command[256];
-    int is_active;
+    int is_active;              // 0 while the job is in the foreground (fg)
     process_state_t state;
-} background_job_t;
+    job_usage_t usage;          // Processes of the job reaped so far
 
-// Global background job storage
-extern background_job_t g_background_jobs[MAX_BACKGROUND_JOBS];
-extern int g_next_job_id;
+    // Index links, owned by jobs.c
+    struct background_job *pid_next;    // Chain in the pid hash
+    struct background_job *id_next;     // Chain in the job-id hash
+    struct background_job *prev, *next; // Job-id order
+} background_job_t;
 
 // Signal handling globals
 extern pid_t g_foreground_pid;
@@ -77,34 +79,36 @@ int log_contains_log_command(const char *command);
 // Background job functions
 void init_background_jobs(void);
 int add_background_job(pid_t pid, const char *command);
-void check_background_jobs(void);
-void cleanup_background_job(int index);
+
+// Job state changes, reported by the event loop (events.c)
+void job_exited(pid_t pid, int status, const struct rusage *ru);
+void job_member_exited(pid_t leader, const struct rusage *ru);
+void job_stopped(pid_t pid);
+void job_continued(pid_t pid);
+void job_stopped_in_foreground(pid_t pid, const char *command, const job_usage_t *usage);
 
 // Activities command
-int execute_activities(void);
+int execute_activities(int argc, char **argv);
 
 // Ping command
-int execute_ping(char *args);
+int execute_ping(int argc, char **argv);
 
-// Signal handling functions
-void setup_signal_handlers(void);
-void sigint_handler(int sig);
-void sigtstp_handler(int sig);
+// Signal handling: SIGINT/SIGTSTP/SIGCHLD arrive through the event loop
 void cleanup_and_exit(void);
-///part ctrol
-
-// Add these lines to the existing declarations in shell.h
-extern volatile sig_atomic_t sigint_received;
-extern volatile sig_atomic_t sigtstp_received;
-
-// Add this function declaration
-// void handle_pending_signals(void);
 
 int add_background_job_running(pid_t pid, const char *command);
 int add_background_job_stopped(pid_t pid, const char *command);
 
 extern int g_hop_called;
 
+// Per-line arena: owns all parse and execution scratch memory of the
+// current input line and is reset at the end of every REPL iteration
+extern arena_t g_line_arena;
+
+// Non-interactive run (-s script or stdin is not a tty): no prompt and
+// fully buffered stdout
+extern int g_batch_mode;
+
 
 #endif
 /* ############## LLM Generated Code Ends ################ */
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef STATS_H
+#define STATS_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <stdint.h>
+
+// Latency histograms of the shell's own work.  Each metric is a
+// log-linear histogram: one row per power of two of nanoseconds, split
+// into STATS_SUB_BUCKETS linear buckets, so any recorded value is off by
+// at most 1/STATS_SUB_BUCKETS.  Recording is one clock read and an array
+// increment; `stats` prints the percentiles.
+
+#define STATS_SUB_BITS 3
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BITS)
+#define STATS_MAX_EXP 40    // 2^40 ns, about 18 minutes; larger values clamp
+#define STATS_BUCKETS ((STATS_MAX_EXP - STATS_SUB_BITS + 2) * STATS_SUB_BUCKETS)
+
+typedef enum
+{
+    STAT_PARSE,         // Line to parse tree (parse cache included)
+    STAT_SPAWN,         // posix_spawn / fork of one process
+    STAT_WAIT,          // Foreground launch to the first wait return
+    STAT_REDIRECT_IN,   // Opening a < file
+    STAT_REDIRECT_OUT,  // Opening a > / >> file
+    STAT_LOG_SAVE,      // Writing the history file
+    STAT_PROMPT,        // Building the prompt
+    STAT_COUNT
+} stat_id_t;
+
+// CLOCK_MONOTONIC in nanoseconds
+uint64_t stats_now(void);
+
+void stats_record(stat_id_t id, uint64_t ns);
+
+// Record the time elapsed since start (a stats_now() value)
+void stats_since(stat_id_t id, uint64_t start);
+
+// stats [-o file]: print the percentiles, or dump the histograms to file
+int execute_stats(int argc, char **argv);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
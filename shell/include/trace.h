@@ -0,0 +1,37 @@
+#ifndef TRACE_H
+#define TRACE_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <sys/types.h>
+
+// Job lifecycle trace.  With SHELL_TRACE=path in the environment every
+// launch, process-group assignment, stop, continue and exit is appended
+// to path as one JSON line carrying a CLOCK_MONOTONIC nanosecond "ts".
+// Each line is a single O_APPEND write, so forked copies of the shell
+// (pipeline builtins, parallel runners) trace into the same file safely.
+// tools/trace2chrome.py turns a trace into Chrome's trace format.
+
+#define TRACE_ENV "SHELL_TRACE"
+
+// Open $SHELL_TRACE if it is set; tracing is off otherwise
+void trace_init(void);
+
+// A process was started; pgid is the group it was put in
+void trace_launch(pid_t pid, pid_t pgid, const char *command);
+
+// Process group pgid was registered as job job_id (0: the foreground)
+void trace_pgid(pid_t pgid, int job_id, const char *command);
+
+void trace_stop(pid_t pid);
+
+// pid was sent SIGCONT by source ("fg", "bg" or "ping")
+void trace_continue(pid_t pid, const char *source);
+
+// pid was reaped with wait status status (-1 if it could not be)
+void trace_exit(pid_t pid, int status);
+
+// close_range(first, ~0U) in a forked child, keeping the trace file open
+void trace_close_fds(unsigned int first);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
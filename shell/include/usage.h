@@ -0,0 +1,52 @@
+#ifndef USAGE_H
+#define USAGE_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <stddef.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+
+// Resource accounting of jobs.  The event loop reaps with wait4, so every
+// process's rusage is added to the job (or foreground pipeline) it belongs
+// to; finished background jobs are kept in a short history for
+// `activities -v`.
+
+#define USAGE_HISTORY 32
+
+typedef struct
+{
+    struct timespec started;    // CLOCK_MONOTONIC
+    double real;                // Seconds; set by usage_finish
+    double user, sys;           // CPU seconds of all reaped processes
+    long max_rss_kb;            // Largest single process
+    long voluntary, involuntary;    // Context switches
+    int processes;
+} job_usage_t;
+
+// Zero u and start its wall clock
+void usage_start(job_usage_t *u);
+
+void usage_add(job_usage_t *u, const struct rusage *ru);
+
+// Stop the wall clock
+void usage_finish(job_usage_t *u);
+
+// "real 1.002s user 0.000s sys 0.001s maxrss 1920KB ctxsw 2/0"
+void usage_format(const job_usage_t *u, char *buf, size_t size);
+
+// u plus what the live process pid has used so far (from /proc), with the
+// wall clock read now
+void usage_sample(const job_usage_t *u, pid_t pid, job_usage_t *out);
+
+// Remember a finished job (status as from wait, -1 if unknown)
+void usage_record(pid_t pid, const char *command, int status, const job_usage_t *u);
+
+// Accounting of a finished job, for members reaped after the leader
+job_usage_t *usage_find_record(pid_t pid);
+
+// Finished jobs, oldest first, in the activities format
+void usage_print_records(void);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
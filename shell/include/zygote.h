@@ -0,0 +1,41 @@
+#ifndef ZYGOTE_H
+#define ZYGOTE_H
+/* ############## LLM Generated Code Begins ############## */
+
+#include <sys/types.h>
+
+// Fork server.  A helper forked while the shell is still small does the
+// fork and exec for launch_process: the shell sends it the resolved path,
+// argv, the current environment, pgid, and the child's cwd and
+// descriptors (SCM_RIGHTS over a Unix socket),
+// so the shell's own address space is never copied and exec latency stays
+// out of the interactive loop.  Children are cloned with CLONE_PARENT, so
+// they are the shell's children and wait/pidfd job control is unchanged.
+//
+// SHELL_ZYGOTE=off in the environment disables it; launches then use
+// posix_spawn, as they also do whenever the helper is gone.
+
+#define ZYGOTE_ENV "SHELL_ZYGOTE"
+
+// Most descriptors kept at their numbers for one command
+#define ZYGOTE_MAX_KEEP 16
+
+// Returned by zygote_spawn when the launch must go through posix_spawn
+#define ZYGOTE_UNAVAILABLE (-1)
+
+// Start the helper; without one, launches fall back silently.  Called
+// once the shell's signal dispositions are set up: the helper and every
+// command it starts inherit them, as posix_spawn children do.
+void zygote_start(void);
+
+// Run path with argv in the shell's current cwd and environment.  fds[0..2]
+// become the child's stdin, stdout and stderr, keep_fds stay open at the
+// same numbers, and pgid is a LAUNCH_* value or a group to join.  Returns
+// 0 with *pid set once the exec has succeeded, the errno of a failed exec,
+// or ZYGOTE_UNAVAILABLE (only the process that started the helper uses
+// it; forked copies of the shell get ZYGOTE_UNAVAILABLE).
+int zygote_spawn(pid_t *pid, const char *path, char *const argv[], const int fds[3],
+                 const int *keep_fds, int keep_count, pid_t pgid);
+
+/* ############## LLM Generated Code Ends ################ */
+#endif
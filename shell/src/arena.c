@@ -0,0 +1,123 @@
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+#define ALIGN_UP(n) (((n) + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1))
+
+void arena_init(arena_t *arena)
+{
+    arena->first = NULL;
+    arena->current = NULL;
+}
+
+// Allocate a chunk with at least min_size usable bytes
+static arena_chunk_t *arena_new_chunk(size_t min_size)
+{
+    size_t size = min_size > ARENA_CHUNK_SIZE ? min_size : ARENA_CHUNK_SIZE;
+    size_t header = ALIGN_UP(sizeof(arena_chunk_t));
+
+    arena_chunk_t *chunk = malloc(header + size);
+    if (!chunk)
+        return NULL;
+
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->data = (unsigned char *)chunk + header;
+    return chunk;
+}
+
+void *arena_alloc(arena_t *arena, size_t size)
+{
+    size = ALIGN_UP(size ? size : 1);
+
+    arena_chunk_t *chunk = arena->current;
+    arena_chunk_t *last = chunk;
+
+    // Walk forward through chunks retained from earlier lines.  They are
+    // reset lazily here, which is what keeps arena_reset O(1).
+    while (chunk && chunk->used + size > chunk->size)
+    {
+        last = chunk;
+        chunk = chunk->next;
+        if (chunk)
+            chunk->used = 0;
+    }
+
+    if (!chunk)
+    {
+        chunk = arena_new_chunk(size);
+        if (!chunk)
+            return NULL;
+
+        if (last)
+        {
+            chunk->next = last->next;
+            last->next = chunk;
+        }
+        else
+        {
+            arena->first = chunk;
+        }
+    }
+
+    arena->current = chunk;
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+// Grow an allocation, in place when it is the most recent one in its chunk
+void *arena_realloc(arena_t *arena, void *ptr, size_t old_size, size_t new_size)
+{
+    if (!ptr)
+        return arena_alloc(arena, new_size);
+
+    arena_chunk_t *chunk = arena->current;
+    size_t old_aligned = ALIGN_UP(old_size ? old_size : 1);
+    size_t new_aligned = ALIGN_UP(new_size ? new_size : 1);
+
+    if (chunk && (unsigned char *)ptr + old_aligned == chunk->data + chunk->used &&
+        chunk->used - old_aligned + new_aligned <= chunk->size)
+    {
+        chunk->used = chunk->used - old_aligned + new_aligned;
+        return ptr;
+    }
+
+    void *new_ptr = arena_alloc(arena, new_size);
+    if (new_ptr)
+        memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    return new_ptr;
+}
+
+char *arena_strdup(arena_t *arena, const char *str)
+{
+    size_t len = strlen(str);
+    char *copy = arena_alloc(arena, len + 1);
+    if (copy)
+        memcpy(copy, str, len + 1);
+    return copy;
+}
+
+void arena_reset(arena_t *arena)
+{
+    arena->current = arena->first;
+    if (arena->first)
+        arena->first->used = 0;
+}
+
+void arena_destroy(arena_t *arena)
+{
+    arena_chunk_t *chunk = arena->first;
+    while (chunk)
+    {
+        arena_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena_init(arena);
+}
+
+/* ############## LLM Generated Code Ends ################ */
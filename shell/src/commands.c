@@ -15,43 +15,22 @@
 #include <fcntl.h>     
 #include <sys/types.h> 
 #include "parser.h"
+#include "parse_cache.h"
+#include "prompt.h"
+#include "pathcache.h"
+#include "events.h"
+#include "jobs.h"
+#include "stats.h"
+#include "trace.h"
 
 
 /* ############## LLM Generated Code Begins ############## */
 
-// ---------------------------------------------
-// Helper function: Trims leading and trailing whitespace from a string
-// ---------------------------------------------
-static char *trim_whitespace(char *str)
-{
-    char *end;
-
-    // Skip leading spaces and tabs
-    while (*str == ' ' || *str == '\t')
-        str++;
-
-    // If the string is now empty, return as is
-    if (*str == 0)
-        return str;
-
-    // Find the end of the string
-    end = str + strlen(str) - 1;
-
-    // Move backwards to skip trailing spaces and tabs
-    while (end > str && (*end == ' ' || *end == '\t'))
-        end--;
-
-    // Null-terminate the new end of string
-    end[1] = '\0';
-
-    return str;
-}
-
 // ---------------------------------------------
 // Function: execute_hop
 // Purpose: Change current working directory based on arguments
 // ---------------------------------------------
-int execute_hop(char *args)
+int execute_hop(int argc, char **argv)
 {
     char current_dir[PATH_MAX];
 
@@ -65,14 +44,15 @@ int execute_hop(char *args)
     // Mark that hop has been called (used for handling '-' behavior elsewhere)
     g_hop_called = 1;
 
-    // If no arguments or only whitespace, go to shell's home directory
-    if (!args || strlen(trim_whitespace(args)) == 0)
+    // If no arguments, go to shell's home directory
+    if (argc < 2)
     {
         if (chdir(g_shell_home) != 0)
         {
             printf("No such directory!\n");
             return -1;
         }
+        prompt_invalidate();
 
         // Update previous directory before changing
         strncpy(g_shell_prev, current_dir, sizeof(g_shell_prev) - 1);
@@ -89,12 +69,11 @@ int execute_hop(char *args)
     }
 
     // ------------------------------
-    // Parse and handle arguments (space/tab-separated)
+    // Handle each argument in turn
     // ------------------------------
-    char *token = strtok(args, " \t");
-
-    while (token != NULL)
+    for (int i = 1; i < argc; i++)
     {
+        const char *token = argv[i];
         char target_dir[PATH_MAX];  // Directory to switch to
 
         // Case 1: ~ => switch to shell's home directory
@@ -106,7 +85,6 @@ int execute_hop(char *args)
         // Case 2: . => current directory, do nothing
         else if (strcmp(token, ".") == 0)
         {
-            token = strtok(NULL, " \t");
             continue;
         }
 
@@ -130,7 +108,6 @@ int execute_hop(char *args)
             // If parent is same as current, skip
             if (strcmp(target_dir, current_dir) == 0)
             {
-                token = strtok(NULL, " \t");
                 continue;
             }
         }
@@ -141,7 +118,6 @@ int execute_hop(char *args)
             if (g_shell_prev[0] == '\0')
             {
                 // No previous directory to go back to
-                token = strtok(NULL, " \t");
                 continue;
             }
 
@@ -168,6 +144,7 @@ int execute_hop(char *args)
             printf("No such directory!\n");
             return -1;
         }
+        prompt_invalidate();
 
         // Successfully changed directory, update previous directory
         strncpy(g_shell_prev, temp_prev, sizeof(g_shell_prev) - 1);
@@ -179,8 +156,6 @@ int execute_hop(char *args)
             perror("hop: getcwd failed");
             return -1;
         }
-
-        token = strtok(NULL, " \t");
     }
 
     return 0;
@@ -197,118 +172,19 @@ int execute_command(const char *input)
         return 0;
     }
 
-    // Make a copy of input for parsing
-    char *input_copy = malloc(strlen(input) + 1);
-    if (!input_copy)
-    {
-        perror("malloc failed");
-        return -1;
-    }
-    strcpy(input_copy, input);
-
-    // Trim leading whitespace
-    char *cmd = input_copy;
-    while (*cmd == ' ' || *cmd == '\t')
-        cmd++;
-
-    // Check if it's a hop command
-    if (strncmp(cmd, "hop", 3) == 0 && (cmd[3] == ' ' || cmd[3] == '\t' || cmd[3] == '\0'))
-    {
-        char *args = NULL;
-        if (cmd[3] != '\0')
-        {
-            args = cmd + 3;
-        }
-        int result = execute_hop(args);
-        free(input_copy);
-        return result;
-    }
-
-    // Check if it's a reveal command
-    if (strncmp(cmd, "reveal", 6) == 0 && (cmd[6] == ' ' || cmd[6] == '\t' || cmd[6] == '\0'))
+    // Builtins and external commands alike go through the parser, which
+    // splits the arguments once; replayed lines are normally served by the
+    // parse cache
+    sequential_commands_t *seq_cmds = parse_cache_acquire(input);
+    if (seq_cmds)
     {
-        char *args = NULL;
-        if (cmd[6] != '\0')
-        {
-            args = cmd + 6;
-        }
-        int result = execute_reveal(args);
-        free(input_copy);
-        return result;
-    }
-
-    // Check if it's a log command
-    if (strncmp(cmd, "log", 3) == 0 && (cmd[3] == ' ' || cmd[3] == '\t' || cmd[3] == '\0'))
-    {
-        char *args = NULL;
-        if (cmd[3] != '\0')
-        {
-            args = cmd + 3;
-        }
-        int result = execute_log(args);
-        free(input_copy);
-        return result;
-    }
-
-    // Check if it's an activities command
-    if (strncmp(cmd, "activities", 10) == 0 && (cmd[10] == ' ' || cmd[10] == '\t' || cmd[10] == '\0'))
-    {
-        int result = execute_activities();
-        free(input_copy);
-        return result;
-    }
-
-    // Check if it's a ping command
-    if (strncmp(cmd, "ping", 4) == 0 && (cmd[4] == ' ' || cmd[4] == '\t' || cmd[4] == '\0'))
-    {
-        char *args = NULL;
-        if (cmd[4] != '\0')
-        {
-            args = cmd + 4;
-        }
-        int result = execute_ping(args);
-        free(input_copy);
-        return result;
-    }
-    // Check if it's a fg command
-    if (strncmp(cmd, "fg", 2) == 0 && (cmd[2] == ' ' || cmd[2] == '\t' || cmd[2] == '\0'))
-    {
-        char *args = NULL;
-        if (cmd[2] != '\0')
-        {
-            args = cmd + 2;
-        }
-        int result = execute_fg(args);
-        free(input_copy);
-        return result;
-    }
-
-    // Check if it's a bg command
-    if (strncmp(cmd, "bg", 2) == 0 && (cmd[2] == ' ' || cmd[2] == '\t' || cmd[2] == '\0'))
-    {
-        char *args = NULL;
-        if (cmd[2] != '\0')
-        {
-            args = cmd + 2;
-        }
-        int result = execute_bg(args);
-        free(input_copy);
-        return result;
-    }
-
-    // Execute external command
-    parsed_command_t external_cmd;
-    if (parse_command_with_redirection(input, &external_cmd) == 0)
-    {
-        int result = execute_command_with_redirection(&external_cmd);
-        cleanup_parsed_command(&external_cmd);
-        free(input_copy);
+        int result = execute_sequential_commands(seq_cmds);
+        parse_cache_release(seq_cmds);
         return result;
     }
     else
     {
         // If parsing fails, just ignore the command
-        free(input_copy);
         return 0;
     }
 }
@@ -336,7 +212,7 @@ static int compare_strings(const void *a, const void *b)
 
 // Replace execute_reveal with this clean version (no debug prints)
 
-int execute_reveal(char *args)
+int execute_reveal(int argc, char **argv)
 {
     int show_all = 0;    // -a flag
     int line_format = 0; // -l flag
@@ -347,99 +223,81 @@ int execute_reveal(char *args)
     target_dir[sizeof(target_dir) - 1] = '\0';
 
     // Parse flags and (optional) path argument
-    if (args)
+    int found_directory = 0;
+    for (int arg = 1; arg < argc; arg++)
     {
-        char *args_copy = strdup(args);
-        if (!args_copy)
+        const char *token = argv[arg];
+        if (token[0] == '-' && token[1] != '\0')
         {
-            perror("reveal: malloc failed");
-            return -1;
+            // Accept combined/duplicated flags like -lalalaa -aaaa
+            for (int i = 1; token[i] != '\0'; i++)
+            {
+                if (token[i] == 'a')
+                    show_all = 1;
+                else if (token[i] == 'l')
+                    line_format = 1;
+                // ignore unknown chars
+            }
         }
-
-        char *token = strtok(args_copy, " \t");
-        int found_directory = 0;
-
-        while (token)
+        else if (strcmp(token, "-") == 0)
         {
-            if (token[0] == '-' && token[1] != '\0')
+            // Handle '-' as directory argument (previous directory)
+            if (found_directory)
             {
-                // Accept combined/duplicated flags like -lalalaa -aaaa
-                for (int i = 1; token[i] != '\0'; i++)
-                {
-                    if (token[i] == 'a')
-                        show_all = 1;
-                    else if (token[i] == 'l')
-                        line_format = 1;
-                    // ignore unknown chars
-                }
+                // Q62: Too many arguments error
+                printf("reveal: Invalid Syntax!\n");
+                return -1;
             }
-            else if (strcmp(token, "-") == 0)
+            found_directory = 1;
+            
+            // printf("DEBUG: g_hop_called = %d\n", g_hop_called);
+            
+            // Check if hop has been called (requirement 9)
+            if (g_hop_called == 0)
             {
-                // Handle '-' as directory argument (previous directory)
-                if (found_directory)
-                {
-                    // Q62: Too many arguments error
-                    printf("reveal: Invalid Syntax!\n");
-                    free(args_copy);
-                    return -1;
-                }
-                found_directory = 1;
-                
-                // printf("DEBUG: g_hop_called = %d\n", g_hop_called);
-                
-                // Check if hop has been called (requirement 9)
-                if (g_hop_called == 0)
-                {
-                    printf("No such directory!\n");
-                    free(args_copy);
-                    return -1;
-                }
-
-                if (g_shell_prev[0] != '\0')
-                {
-                    strncpy(target_dir, g_shell_prev, sizeof(target_dir) - 1);
-                }
-                else
-                {
-                    printf("No such directory!\n");
-                    free(args_copy);
-                    return -1;
-                }
-                target_dir[sizeof(target_dir) - 1] = '\0';
+                printf("No such directory!\n");
+                return -1;
             }
-            else if (!found_directory)
+
+            if (g_shell_prev[0] != '\0')
             {
-                // First non-flag token is the directory argument
-                found_directory = 1;
-                if (strcmp(token, "~") == 0)
-                {
-                    strncpy(target_dir, g_shell_home, sizeof(target_dir) - 1);
-                }
-                else if (strcmp(token, ".") == 0)
-                {
-                    strncpy(target_dir, ".", sizeof(target_dir) - 1);
-                }
-                else if (strcmp(token, "..") == 0)
-                {
-                    strncpy(target_dir, "..", sizeof(target_dir) - 1);
-                }
-                else
-                {
-                    strncpy(target_dir, token, sizeof(target_dir) - 1);
-                }
-                target_dir[sizeof(target_dir) - 1] = '\0';
+                strncpy(target_dir, g_shell_prev, sizeof(target_dir) - 1);
             }
             else
             {
-                // Q62: Too many arguments error
-                printf("reveal: Invalid Syntax!\n");
-                free(args_copy);
+                printf("No such directory!\n");
                 return -1;
             }
-            token = strtok(NULL, " \t");
+            target_dir[sizeof(target_dir) - 1] = '\0';
+        }
+        else if (!found_directory)
+        {
+            // First non-flag token is the directory argument
+            found_directory = 1;
+            if (strcmp(token, "~") == 0)
+            {
+                strncpy(target_dir, g_shell_home, sizeof(target_dir) - 1);
+            }
+            else if (strcmp(token, ".") == 0)
+            {
+                strncpy(target_dir, ".", sizeof(target_dir) - 1);
+            }
+            else if (strcmp(token, "..") == 0)
+            {
+                strncpy(target_dir, "..", sizeof(target_dir) - 1);
+            }
+            else
+            {
+                strncpy(target_dir, token, sizeof(target_dir) - 1);
+            }
+            target_dir[sizeof(target_dir) - 1] = '\0';
+        }
+        else
+        {
+            // Q62: Too many arguments error
+            printf("reveal: Invalid Syntax!\n");
+            return -1;
         }
-
-        free(args_copy);
     }
 
     // Open directory
@@ -575,7 +433,7 @@ int log_init(void)
     return 0;
 }
 // this one
-static int log_save(void)
+static int log_save_file(void)
 {
     char log_path[PATH_MAX];
 
@@ -606,6 +464,14 @@ static int log_save(void)
     fclose(file);
     return 0;
 }
+
+static int log_save(void)
+{
+    uint64_t start = stats_now();
+    int result = log_save_file();
+    stats_since(STAT_LOG_SAVE, start);
+    return result;
+}
 // Also fix the log purge in execute_log function
 
 // Check if command contains 'log' as a command name
@@ -676,9 +542,9 @@ void log_add_command(const char *command)
     log_save();
 }
 // Execute log command
-int execute_log(char *args)
+int execute_log(int argc, char **argv)
 {
-    if (!args || strlen(trim_whitespace(args)) == 0)
+    if (argc < 2)
     {
         // No arguments: print commands oldest to newest
         for (int i = 0; i < g_log_count; i++)
@@ -689,21 +555,7 @@ int execute_log(char *args)
         return 0;
     }
 
-    // Parse arguments
-    char *args_copy = malloc(strlen(args) + 1);
-    if (!args_copy)
-    {
-        perror("log: malloc failed");
-        return -1;
-    }
-    strcpy(args_copy, args);
-
-    char *token = strtok(args_copy, " \t");
-    if (!token)
-    {
-        free(args_copy);
-        return 0;
-    }
+    const char *token = argv[1];
 
     if (strcmp(token, "purge") == 0)
     {
@@ -722,7 +574,18 @@ int execute_log(char *args)
             fclose(file);
         }
 
-        free(args_copy);
+        return 0;
+    }
+
+    else if (strcmp(token, "cache") == 0)
+    {
+        // Report how often replayed lines skipped parsing
+        unsigned long hits, misses;
+        int entries;
+        parse_cache_stats(&hits, &misses, &entries);
+        printf("parse cache: %lu hits, %lu misses, %d/%d entries\n",
+               hits, misses, entries, PARSE_CACHE_SETS * PARSE_CACHE_WAYS);
+
         return 0;
     }
 
@@ -730,88 +593,68 @@ int execute_log(char *args)
     else if (strcmp(token, "execute") == 0)
     {
         // Execute command at index
-        token = strtok(NULL, " \t");
-        if (!token)
+        if (argc < 3)
         {
             printf("log: execute requires an index\n");
-            free(args_copy);
             return -1;
         }
 
-        int index = atoi(token);
+        int index = atoi(argv[2]);
         if (index < 1 || index > g_log_count)
         {
             printf("log: invalid index %d\n", index);
-            free(args_copy);
             return -1;
         }
 
         // Convert to 0-based index (newest to oldest)
         int cmd_idx = (g_log_start + g_log_count - index) % MAX_LOG_COMMANDS;
 
+        // A stored line may itself run log execute (only lines starting
+        // with log are kept out of the log); replaying from inside a
+        // replay could recurse without end
+        static int s_replaying = 0;
+        if (s_replaying)
+        {
+            printf("log: execute cannot be used inside a replayed command\n");
+            return -1;
+        }
+
         // Execute the command without adding to log
         printf("%s\n", g_log_commands[cmd_idx]); // Show what we're executing
+        s_replaying = 1;
         execute_command(g_log_commands[cmd_idx]);
+        s_replaying = 0;
 
-        free(args_copy);
         return 0;
     }
     else
     {
         printf("log: unknown argument '%s'\n", token);
-        free(args_copy);
         return -1;
     }
 }
 
-// Add this function to src/commands.c after the existing execute_hop function
-
-// Direct hop execution for redirection
-int execute_hop_direct(char *args)
-{
-    return execute_hop(args);
-}
-
 // part e1
 
-// Initialize background job management
-void init_background_jobs(void)
-{
-    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++)
-    {
-        g_background_jobs[i].is_active = 0;
-        g_background_jobs[i].job_id = 0;
-        g_background_jobs[i].pid = 0;
-        g_background_jobs[i].command[0] = '\0';
-        g_background_jobs[i].state = PROCESS_TERMINATED;
-    }
-    g_next_job_id = 1;
-}
-
-// Add a new background job
 // Add a new background job
 int add_background_job(pid_t pid, const char *command)
 {
-    // Find an empty slot
-    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++)
+    background_job_t *job = jobs_add(pid, command);
+    if (!job)
     {
-        if (!g_background_jobs[i].is_active)
-        {
-            g_background_jobs[i].job_id = g_next_job_id++;
-            g_background_jobs[i].pid = pid;
-            g_background_jobs[i].is_active = 1;
-            g_background_jobs[i].state = PROCESS_RUNNING;
+        perror("malloc failed");
+        return -1;
+    }
 
-            // Copy command name (truncate if too long)
-            strncpy(g_background_jobs[i].command, command, sizeof(g_background_jobs[i].command) - 1);
-            g_background_jobs[i].command[sizeof(g_background_jobs[i].command) - 1] = '\0';
+    // DON'T print job information here anymore - let the caller handle it
 
-            // DON'T print job information here anymore - let the caller handle it
+    usage_start(&job->usage);
+    trace_pgid(pid, job->job_id, command);
 
-            return g_background_jobs[i].job_id;
-        }
-    }
-    return -1; // No available slots
+    // Its exit is reported by the event loop as soon as it happens
+    events_watch_job(pid);
+
+    return job->job_id;
 }
 
 // Add these RIGHT AFTER your existing add_background_job function in src/commands.c
@@ -837,14 +680,7 @@ int add_background_job_stopped(pid_t pid, const char *command)
     if (job_id > 0)
     {
         // Update state to stopped
-        for (int i = 0; i < MAX_BACKGROUND_JOBS; i++)
-        {
-            if (g_background_jobs[i].is_active && g_background_jobs[i].pid == pid)
-            {
-                g_background_jobs[i].state = PROCESS_STOPPED;
-                break;
-            }
-        }
+        jobs_find_pid(pid)->state = PROCESS_STOPPED;
         // Print job stop notification (E.3 Requirement 4)
         fprintf(stderr, "[%d] Stopped %s\n", job_id, command);
         fflush(stderr);
@@ -852,123 +688,111 @@ int add_background_job_stopped(pid_t pid, const char *command)
     return job_id;
 }
 
-// Check for completed background jobs (non-blocking)
-void check_background_jobs(void)
+// Event loop callbacks (events.c): a job's process exited (status -1 if
+// it could not be collected), stopped or was continued
+void job_exited(pid_t pid, int status, const struct rusage *ru)
 {
-    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++)
+    background_job_t *job = jobs_find_pid(pid);
+    if (!job || !job->is_active)
+        return;
+
+    usage_add(&job->usage, ru);
+    usage_finish(&job->usage);
+    usage_record(job->pid, job->command, status, &job->usage);
+
+    if (status != -1 && WIFEXITED(status))
     {
-        if (g_background_jobs[i].is_active)
-        {
-            int status;
-#ifdef WCONTINUED
-            pid_t result = waitpid(g_background_jobs[i].pid, &status, WNOHANG | WUNTRACED | WCONTINUED);
-#else
-            pid_t result = waitpid(g_background_jobs[i].pid, &status, WNOHANG | WUNTRACED);
-#endif
-
-            if (result == g_background_jobs[i].pid)
-            {
-                if (WIFEXITED(status))
-                {
-                    // Process exited normally with exit code
-                    fprintf(stderr, "%s with pid %d exited normally\n", 
-                            g_background_jobs[i].command, g_background_jobs[i].pid);
-                }
-                else if (WIFSIGNALED(status))
-                {
-                    // Process was terminated by a signal
-                    fprintf(stderr, "%s with pid %d exited abnormally\n", 
-                            g_background_jobs[i].command, g_background_jobs[i].pid);
-                }
-                else if (WIFSTOPPED(status))
-                {
-                    // Process has been stopped (Ctrl+Z)
-                    g_background_jobs[i].state = PROCESS_STOPPED;
-                    continue; // Don't mark as terminated
-                }
-                else if (WIFCONTINUED(status))
-{
-    // Process has been continued - only update if it was actually stopped
-    if (g_background_jobs[i].state == PROCESS_STOPPED) {
-        g_background_jobs[i].state = PROCESS_RUNNING;
+        // Process exited normally with exit code
+        fprintf(stderr, "%s with pid %d exited normally\n", job->command, job->pid);
     }
-    continue; // Don't mark as terminated
-}
-                fflush(stderr);
-                // Mark job as inactive (only for terminated processes)
-                g_background_jobs[i].is_active = 0;
-                g_background_jobs[i].state = PROCESS_TERMINATED;
-            }
-            else if (result == -1)
-{
-    // Error or process doesn't exist anymore - SHOW OUTPUT
-    fprintf(stderr, "%s with pid %d exited abnormally\n", 
-           g_background_jobs[i].command, g_background_jobs[i].pid);
-    fflush(stderr);
-    g_background_jobs[i].is_active = 0;
-    g_background_jobs[i].state = PROCESS_TERMINATED;
-}
-            // result == 0 means process is still running (no state change)
-        }
+    else
+    {
+        // Process was terminated by a signal
+        fprintf(stderr, "%s with pid %d exited abnormally\n", job->command, job->pid);
     }
+    fflush(stderr);
+
+    jobs_remove(job);
 }
-// Cleanup a specific background job
-void cleanup_background_job(int index)
+
+// A non-leader member of the job led by leader was reaped; the job may
+// already be finished
+void job_member_exited(pid_t leader, const struct rusage *ru)
 {
-    if (index >= 0 && index < MAX_BACKGROUND_JOBS)
-    {
-        g_background_jobs[index].is_active = 0;
-        g_background_jobs[index].job_id = 0;
-        g_background_jobs[index].pid = 0;
-        g_background_jobs[index].command[0] = '\0';
-        g_background_jobs[index].state = PROCESS_TERMINATED;
-    }
+    background_job_t *job = jobs_find_pid(leader);
+    job_usage_t *usage = job ? &job->usage : usage_find_record(leader);
+    if (usage)
+        usage_add(usage, ru);
 }
 
-// Helper structure for sorting activities
-typedef struct
+void job_stopped(pid_t pid)
 {
-    pid_t pid;
-    char command[256];
-    process_state_t state;
-} activity_entry_t;
+    background_job_t *job = jobs_find_pid(pid);
+    if (job && job->is_active)
+        job->state = PROCESS_STOPPED;
+}
 
-// Comparison function for sorting activities by command name
-static int compare_activities(const void *a, const void *b)
+void job_continued(pid_t pid)
 {
-    const activity_entry_t *entry_a = (const activity_entry_t *)a;
-    const activity_entry_t *entry_b = (const activity_entry_t *)b;
-    return strcmp(entry_a->command, entry_b->command);
+    // Only update if it was actually stopped
+    background_job_t *job = jobs_find_pid(pid);
+    if (job && job->is_active && job->state == PROCESS_STOPPED)
+        job->state = PROCESS_RUNNING;
 }
 
-// Execute activities command
-int execute_activities(void)
+// The foreground group led by pid was stopped (Ctrl-Z): it becomes a job
+// again, under its old number if it was one before fg, and keeps the
+// accounting of its processes collected so far
+void job_stopped_in_foreground(pid_t pid, const char *command, const job_usage_t *usage)
 {
-    activity_entry_t activities[MAX_BACKGROUND_JOBS];
-    int activity_count = 0;
+    background_job_t *job = jobs_find_pid(pid);
+    if (job && !job->is_active)
+    {
+        if (usage && usage != &job->usage)
+            job->usage = *usage;
+        // Restore the original job
+        job->is_active = 1;
+        job->state = PROCESS_STOPPED;
+        events_watch_job(pid);
+        fprintf(stderr, "[%d] Stopped %s\n", job->job_id, command);
+        fflush(stderr);
+        return;
+    }
 
-    // Collect all active processes
-    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++)
+    // If not found, create a new job
+    if (add_background_job_stopped(pid, command) > 0 && usage)
+        jobs_find_pid(pid)->usage = *usage;
+}
+
+// Execute activities command; -v adds resource usage and the recently
+// finished jobs
+int execute_activities(int argc, char **argv)
+{
+    int verbose = 0;
+    if (argc > 1)
     {
-        if (g_background_jobs[i].is_active)
+        if (argc > 2 || strcmp(argv[1], "-v") != 0)
         {
-            activities[activity_count].pid = g_background_jobs[i].pid;
-            strncpy(activities[activity_count].command, g_background_jobs[i].command,
-                    sizeof(activities[activity_count].command) - 1);
-            activities[activity_count].command[sizeof(activities[activity_count].command) - 1] = '\0';
-            activities[activity_count].state = g_background_jobs[i].state;
-            activity_count++;
+            printf("activities: usage: activities [-v]\n");
+            return -1;
         }
+        verbose = 1;
     }
 
-    // Sort activities lexicographically by command name
-    qsort(activities, activity_count, sizeof(activity_entry_t), compare_activities);
+    // The table keeps an index sorted by command name
+    int count;
+    background_job_t *const *jobs = jobs_by_command(&count);
 
     // Print sorted activities
-    for (int i = 0; i < activity_count; i++)
+    for (int i = 0; i < count; i++)
     {
+        if (!jobs[i]->is_active)
+        {
+            continue;
+        }
+
         const char *state_str;
-        switch (activities[i].state)
+        switch (jobs[i]->state)
         {
         case PROCESS_RUNNING:
             state_str = "Running";
@@ -981,9 +805,22 @@ int execute_activities(void)
             break;
         }
 
-        printf("[%d] : %s - %s\n", activities[i].pid, activities[i].command, state_str);
+        if (!verbose)
+        {
+            printf("[%d] : %s - %s\n", jobs[i]->pid, jobs[i]->command, state_str);
+            continue;
+        }
+
+        job_usage_t live;
+        char usage_str[160];
+        usage_sample(&jobs[i]->usage, jobs[i]->pid, &live);
+        usage_format(&live, usage_str, sizeof usage_str);
+        printf("[%d] : %s - %s - %s\n", jobs[i]->pid, jobs[i]->command, state_str, usage_str);
     }
 
+    if (verbose)
+        usage_print_records();
+
     return 0;
 }
 
@@ -991,30 +828,15 @@ int execute_activities(void)
 //  Add this function to the END of src/commands.c
 
 // Execute ping command
-int execute_ping(char *args)
+int execute_ping(int argc, char **argv)
 {
-    if (!args || strlen(trim_whitespace(args)) == 0)
+    if (argc < 2)
     {
         printf("ping: requires <pid> <signal_number>\n");
         return -1;
     }
 
-    // Parse arguments
-    char *args_copy = malloc(strlen(args) + 1);
-    if (!args_copy)
-    {
-        perror("ping: malloc failed");
-        return -1;
-    }
-    strcpy(args_copy, args);
-
-    char *token = strtok(args_copy, " \t");
-    if (!token)
-    {
-        printf("ping: requires <pid> <signal_number>\n");
-        free(args_copy);
-        return -1;
-    }
+    const char *token = argv[1];
 
     // Parse PID
     char *endptr;
@@ -1022,26 +844,23 @@ int execute_ping(char *args)
     if (*endptr != '\0' || pid_long <= 0)
     {
         printf("ping: invalid PID '%s'\n", token);
-        free(args_copy);
         return -1;
     }
     pid_t pid = (pid_t)pid_long;
 
     // Parse signal number
-    token = strtok(NULL, " \t");
-    if (!token)
+    if (argc < 3)
     {
         printf("ping: requires <pid> <signal_number>\n");
-        free(args_copy);
         return -1;
     }
 
+    token = argv[2];
     long signal_long = strtol(token, &endptr, 10);
     if (*endptr != '\0')
     {
         // printf("ping: invalid signal number '%s'\n", token);
         printf("Invalid syntax!\n");
-        free(args_copy);
         return -1;
     }
 
@@ -1050,11 +869,9 @@ int execute_ping(char *args)
     int actual_signal = original_signal % 32;
 
     // Check for extra arguments
-    token = strtok(NULL, " \t");
-    if (token)
+    if (argc > 3)
     {
         printf("ping: too many arguments\n");
-        free(args_copy);
         return -1;
     }
 
@@ -1070,105 +887,48 @@ int execute_ping(char *args)
         {
             perror("ping: failed to send signal");
         }
-        free(args_copy);
         return -1;
     }
 
-    // Success message (Requirement 3)
-    printf("Sent signal %d to process with pid %d\n", original_signal, pid);
-
-    free(args_copy);
-    return 0;
-}
-
-void sigint_handler(int sig)
-{
-    (void)sig;
-
-    // Only send signal to foreground process group if one exists
-    if (g_foreground_pgid > 0)
+    if (actual_signal == SIGCONT)
     {
-        killpg(g_foreground_pgid, SIGINT);
-        
-        // Clear foreground process info
-        g_foreground_pid = 0;
-        g_foreground_pgid = 0;
-        g_foreground_command[0] = '\0';
+        trace_continue(pid, "ping");
     }
-    // DON'T call printf, write, or other I/O functions here
-}
 
-void sigtstp_handler(int sig)
-{
-    (void)sig;
-
-    // Only handle if there's actually a foreground process
-    if (g_foreground_pgid > 0 && g_foreground_pid > 0)
-    {
-        killpg(g_foreground_pgid, SIGTSTP);
-
-        // Save process info before clearing
-        pid_t stopped_pid = g_foreground_pid;
-        char stopped_command[256];
-        strncpy(stopped_command, g_foreground_command, sizeof(stopped_command) - 1);
-        stopped_command[sizeof(stopped_command) - 1] = '\0';
-
-        // Clear foreground process info
-        g_foreground_pid = 0;
-        g_foreground_pgid = 0;
-        g_foreground_command[0] = '\0';
-
-        // Add stopped job to background (notification handled by the function)
-        // Check if this process was previously a background job
-int restored_job_id = -1;
-for (int i = 0; i < MAX_BACKGROUND_JOBS; i++) {
-    if (!g_background_jobs[i].is_active && g_background_jobs[i].pid == stopped_pid) {
-        // Restore the original job
-        g_background_jobs[i].is_active = 1;
-        g_background_jobs[i].state = PROCESS_STOPPED;
-        restored_job_id = g_background_jobs[i].job_id;
-        fprintf(stderr, "[%d] Stopped %s\n", restored_job_id, stopped_command);
-        fflush(stderr);
-        break;
-    }
-}
+    // Success message (Requirement 3)
+    printf("Sent signal %d to process with pid %d\n", original_signal, pid);
 
-// If not found, create a new job
-if (restored_job_id == -1) {
-    add_background_job_stopped(stopped_pid, stopped_command);
-}
-    }
+    return 0;
 }
 
-// Setup signal handlers using simple signal() function
-void setup_signal_handlers(void)
+// Execute hash command: list, clear (-r) or pre-warm the PATH cache
+int execute_hash(int argc, char **argv)
 {
-    struct sigaction sa_int, sa_tstp;
-
-    // Requirement 1 for Ctrl-C: Install signal handler for SIGINT
-    memset(&sa_int, 0, sizeof(sa_int));
-    sa_int.sa_handler = sigint_handler;
-    sigemptyset(&sa_int.sa_mask);
-    sa_int.sa_flags = SA_RESTART;
-
-    if (sigaction(SIGINT, &sa_int, NULL) == -1)
+    if (argc < 2)
     {
-        perror("sigaction SIGINT");
+        path_cache_print();
+        return 0;
     }
 
-    // Requirement 1 for Ctrl-Z: Install signal handler for SIGTSTP
-    memset(&sa_tstp, 0, sizeof(sa_tstp));
-    sa_tstp.sa_handler = sigtstp_handler;
-    sigemptyset(&sa_tstp.sa_mask);
-    sa_tstp.sa_flags = SA_RESTART;
-
-    if (sigaction(SIGTSTP, &sa_tstp, NULL) == -1)
+    int result = 0;
+    for (int i = 1; i < argc; i++)
     {
-        perror("sigaction SIGTSTP");
+        if (strcmp(argv[i], "-r") == 0)
+        {
+            path_cache_clear();
+        }
+        else if (argv[i][0] == '-')
+        {
+            printf("hash: %s: invalid option\n", argv[i]);
+            return -1;
+        }
+        else if (path_cache_add(argv[i]) != 0)
+        {
+            printf("hash: %s: not found\n", argv[i]);
+            result = -1;
+        }
     }
-
-    // Ignore SIGTTOU to avoid being stopped when writing to terminal
-    signal(SIGTTOU, SIG_IGN);
+    return result;
 }
 
 // Cleanup and exit function (for Ctrl-D)
@@ -1177,11 +937,11 @@ void cleanup_and_exit(void)
     printf("logout\n");
 
     // Send SIGKILL to all active background processes
-    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++)
+    for (background_job_t *job = jobs_first(); job; job = job->next)
     {
-        if (g_background_jobs[i].is_active && g_background_jobs[i].pid > 0)
+        if (job->is_active && job->pid > 0)
         {
-            kill(g_background_jobs[i].pid, SIGKILL);
+            kill(job->pid, SIGKILL);
         }
     }
 
@@ -1191,45 +951,14 @@ void cleanup_and_exit(void)
 // part e3
 //  Add these functions to the end of src/commands.c
 
-// Helper function to find job by job ID
-background_job_t *find_job_by_id(int job_id)
-{
-    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++)
-    {
-        if (g_background_jobs[i].is_active && g_background_jobs[i].job_id == job_id)
-        {
-            return &g_background_jobs[i];
-        }
-    }
-    return NULL;
-}
-
-// Helper function to find most recent job (highest job_id)
-background_job_t *find_most_recent_job(void)
-{
-    background_job_t *most_recent = NULL;
-    int highest_job_id = 0;
-
-    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++)
-    {
-        if (g_background_jobs[i].is_active && g_background_jobs[i].job_id > highest_job_id)
-        {
-            highest_job_id = g_background_jobs[i].job_id;
-            most_recent = &g_background_jobs[i];
-        }
-    }
-    return most_recent;
-}
-
-
-int execute_fg(char *args)
+int execute_fg(int argc, char **argv)
 {
     background_job_t *job = NULL;
 
-    if (!args || strlen(trim_whitespace(args)) == 0)
+    if (argc < 2)
     {
         // No job number provided, use most recent job
-        job = find_most_recent_job();
+        job = jobs_most_recent();
         if (!job)
         {
             printf("No jobs in background\n");
@@ -1239,41 +968,22 @@ int execute_fg(char *args)
     else
     {
         // Parse job number
-        char *args_copy = malloc(strlen(args) + 1);
-        if (!args_copy)
-        {
-            perror("fg: malloc failed");
-            return -1;
-        }
-        strcpy(args_copy, args);
-
-        char *token = strtok(args_copy, " \t");
-        if (!token)
-        {
-            printf("fg: invalid job number\n");
-            free(args_copy);
-            return -1;
-        }
-
+        const char *token = argv[1];
         char *endptr;
         long job_id_long = strtol(token, &endptr, 10);
         if (*endptr != '\0' || job_id_long <= 0)
         {
             printf("fg: invalid job number '%s'\n", token);
-            free(args_copy);
             return -1;
         }
 
         int job_id = (int)job_id_long;
-        job = find_job_by_id(job_id);
+        job = jobs_find_id(job_id);
         if (!job)
         {
             printf("No such job\n");
-            free(args_copy);
             return -1;
         }
-
-        free(args_copy);
     }
 
     // Check if the process still exists
@@ -1282,7 +992,7 @@ int execute_fg(char *args)
         if (errno == ESRCH)
         {
             printf("No such job\n");
-            job->is_active = 0;
+            jobs_remove(job);
             return -1;
         }
     }
@@ -1298,8 +1008,10 @@ int execute_fg(char *args)
     job_command[sizeof(job_command) - 1] = '\0';
     process_state_t job_state = job->state;
 
-    // Remove job from background jobs list while in foreground
+    // Take the job out of the background list while in foreground; the
+    // record stays so that Ctrl-Z can give it its old number back
     job->is_active = 0;
+    events_unwatch(job_pid);
 
     // Set this job as the foreground job
     g_foreground_pid = job_pid;
@@ -1310,17 +1022,20 @@ int execute_fg(char *args)
     // If job is stopped, send SIGCONT to resume it
     if (job_state == PROCESS_STOPPED)
     {
+        trace_continue(job_pid, "fg");
         if (kill(job_pid, SIGCONT) == -1)
         {
             if (errno == ESRCH)
             {
                 printf("No such job\n");
+                jobs_remove(job);
                 g_foreground_pid = 0;
                 g_foreground_pgid = 0;
                 g_foreground_command[0] = '\0';
                 return -1;
             }
             perror("fg: failed to send SIGCONT");
+            jobs_remove(job);
             g_foreground_pid = 0;
             g_foreground_pgid = 0;
             g_foreground_command[0] = '\0';
@@ -1328,63 +1043,40 @@ int execute_fg(char *args)
         }
     }
 
-    // Wait for the job to complete or stop again
+    // Wait for the job to complete or stop again; if it stops, the event
+    // loop puts it back in the job list
     int status;
-    pid_t result;
-
-    while (1)
-    {
-        result = waitpid(job_pid, &status, WUNTRACED);
-
-        if (result == -1)
-        {
-            if (errno == EINTR)
-            {
-                continue;
-            }
-            else if (errno == ECHILD)
-            {
-                break;
-            }
-            else
-            {
-                perror("fg: waitpid failed");
-                g_foreground_pid = 0;
-                g_foreground_pgid = 0;
-                g_foreground_command[0] = '\0';
-                return -1;
-            }
-        }
-        else if (result == job_pid)
-        {
-            break;
-        }
-        else
-        {
-            continue;
-        }
-    }
-
-    // Job handling:
-    // - If stopped (WIFSTOPPED): signal handler will re-add it to background list
-    // - If terminated: job is already removed and stays removed
+    int stopped = events_wait_foreground(&job_pid, &status, 1, &job->usage);
 
     // Clear foreground process info
     g_foreground_pid = 0;
     g_foreground_pgid = 0;
     g_foreground_command[0] = '\0';
 
+    if (stopped)
+    {
+        return 0;
+    }
+
+    // Finished in the foreground: the job is gone for good
+    usage_finish(&job->usage);
+    usage_record(job->pid, job->command, status, &job->usage);
+    jobs_remove(job);
+    if (status == -1)
+    {
+        return 0;
+    }
     return WIFEXITED(status) ? WEXITSTATUS(status) : 0;
 }
 // Execute bg command
-int execute_bg(char *args)
+int execute_bg(int argc, char **argv)
 {
     background_job_t *job = NULL;
 
-    if (!args || strlen(trim_whitespace(args)) == 0)
+    if (argc < 2)
     {
         // No job number provided, use most recent job
-        job = find_most_recent_job();
+        job = jobs_most_recent();
         if (!job)
         {
             printf("No jobs in background\n");
@@ -1394,41 +1086,22 @@ int execute_bg(char *args)
     else
     {
         // Parse job number
-        char *args_copy = malloc(strlen(args) + 1);
-        if (!args_copy)
-        {
-            perror("bg: malloc failed");
-            return -1;
-        }
-        strcpy(args_copy, args);
-
-        char *token = strtok(args_copy, " \t");
-        if (!token)
-        {
-            printf("bg: invalid job number\n");
-            free(args_copy);
-            return -1;
-        }
-
+        const char *token = argv[1];
         char *endptr;
         long job_id_long = strtol(token, &endptr, 10);
         if (*endptr != '\0' || job_id_long <= 0)
         {
             printf("bg: invalid job number '%s'\n", token);
-            free(args_copy);
             return -1;
         }
 
         int job_id = (int)job_id_long;
-        job = find_job_by_id(job_id);
+        job = jobs_find_id(job_id);
         if (!job)
         {
             printf("No such job\n");
-            free(args_copy);
             return -1;
         }
-
-        free(args_copy);
     }
 
     // Check if job is already running
@@ -1446,12 +1119,13 @@ int execute_bg(char *args)
     }
 
     // Send SIGCONT to resume the job
+    trace_continue(job->pid, "bg");
     if (kill(job->pid, SIGCONT) == -1)
     {
         if (errno == ESRCH)
         {
             // Process no longer exists, remove from job list
-            job->is_active = 0;
+            jobs_remove(job);
             printf("No such job\n");
         }
         else
@@ -0,0 +1,555 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include "shell.h"
+#include "events.h"
+#include "prompt.h"
+#include "jobs.h"
+#include "usage.h"
+#include "stats.h"
+#include "trace.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+typedef enum
+{
+    WATCH_JOB,        // Background job leader: exit is reported
+    WATCH_QUIET,      // Only reaped
+    WATCH_FOREGROUND  // Part of the current foreground wait
+} watch_kind_t;
+
+typedef struct watch
+{
+    struct watch *next; // Bucket chain
+    pid_t pid;
+    int fd;             // pidfd, or -1 where pidfd_open is unavailable
+    watch_kind_t kind;
+    int index;          // WATCH_FOREGROUND: slot in the foreground wait
+    pid_t owner;        // WATCH_QUIET: leader of the job it belongs to
+} watch_t;
+
+static watch_t *s_watches[EVENTS_WATCH_BUCKETS];
+static int s_unpolled = 0;      // Watches without a pidfd; checked on SIGCHLD
+
+static int s_epoll = -1;
+static int s_signal_fd = -1;
+static int s_input_fd = -1;
+static int s_input_pollable = 0;
+
+// epoll_event.data.ptr of the non-pid descriptors
+static char s_input_tag, s_signal_tag, s_timer_tag;
+
+// The ticker: a timerfd in the set while one is installed
+static int s_timer_fd = -1;
+static void (*s_tick)(void *arg);
+static void *s_tick_arg;
+
+static int s_input_ready = 0;
+static int s_at_prompt = 0;     // Waiting for input with a prompt showing
+static int s_prompt_stale = 0;  // A notification was printed over it
+
+// The foreground wait in progress
+static struct
+{
+    int *statuses;
+    job_usage_t *usage; // Where the reaped processes are accounted
+    int remaining;
+    int stopped;
+    int interrupted;    // Ctrl-C arrived
+    uint64_t started;   // Wait start, until the first process is reaped
+} s_fg;
+
+static int pidfd_open(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+static watch_t **find_slot(pid_t pid)
+{
+    watch_t **slot = &s_watches[(unsigned)pid % EVENTS_WATCH_BUCKETS];
+    while (*slot && (*slot)->pid != pid)
+        slot = &(*slot)->next;
+    return slot;
+}
+
+// Set up the loop again in a child after events_reset_child
+static void ensure_loop(void)
+{
+    if (s_epoll == -1)
+        events_init(s_input_fd);
+}
+
+static watch_t *add_watch(pid_t pid, watch_kind_t kind, int index)
+{
+    ensure_loop();
+
+    watch_t **slot = find_slot(pid);
+    if (*slot)
+    {
+        (*slot)->kind = kind;
+        (*slot)->index = index;
+        (*slot)->owner = 0;
+        return *slot;
+    }
+
+    watch_t *w = malloc(sizeof *w);
+    if (!w)
+    {
+        perror("malloc failed");
+        return NULL;
+    }
+    w->pid = pid;
+    w->kind = kind;
+    w->index = index;
+    w->owner = 0;
+    w->next = NULL;
+
+    // Without pidfds (old kernels) the watch is checked on every SIGCHLD
+    w->fd = pidfd_open(pid);
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = w};
+    if (w->fd != -1 && epoll_ctl(s_epoll, EPOLL_CTL_ADD, w->fd, &ev) == -1)
+    {
+        close(w->fd);
+        w->fd = -1;
+    }
+    if (w->fd == -1)
+        s_unpolled++;
+
+    *slot = w;
+    return w;
+}
+
+static void remove_watch(watch_t *w)
+{
+    watch_t **slot = find_slot(w->pid);
+    *slot = w->next;
+
+    // Drop the pidfd from the epoll set explicitly: a child forked in the
+    // meantime may still hold a copy, which would keep it registered (and
+    // reporting this freed watch) after the close
+    if (w->fd != -1)
+    {
+        epoll_ctl(s_epoll, EPOLL_CTL_DEL, w->fd, NULL);
+        close(w->fd);
+    }
+    else
+        s_unpolled--;
+    free(w);
+}
+
+static void report_exit(pid_t pid, int status, const struct rusage *ru)
+{
+    // Keep the notification off the prompt line
+    if (s_at_prompt && !g_batch_mode && !s_prompt_stale && jobs_find_pid(pid))
+    {
+        printf("\n");
+        fflush(stdout);
+        s_prompt_stale = 1;
+    }
+    job_exited(pid, status, ru);
+}
+
+// The watched process may have exited; reap it if so.  wait4 hands back
+// its resource usage, which goes to the job or foreground wait it is in.
+static void reap(watch_t *w)
+{
+    int status;
+    struct rusage ru;
+    pid_t result = wait4(w->pid, &status, WNOHANG, &ru);
+    if (result == 0 || (result == -1 && errno == EINTR))
+        return;
+    if (result == -1)
+    {
+        status = -1;  // Already gone; reported as abnormal
+        memset(&ru, 0, sizeof ru);
+    }
+
+    pid_t pid = w->pid;
+    watch_kind_t kind = w->kind;
+    int index = w->index;
+    pid_t owner = w->owner;
+    remove_watch(w);
+    trace_exit(pid, status);
+
+    if (kind == WATCH_JOB)
+    {
+        report_exit(pid, status, &ru);
+    }
+    else if (kind == WATCH_QUIET)
+    {
+        if (owner > 0)
+            job_member_exited(owner, &ru);
+    }
+    else if (kind == WATCH_FOREGROUND && s_fg.statuses)
+    {
+        s_fg.statuses[index] = status;
+        s_fg.remaining--;
+        if (s_fg.started)
+        {
+            stats_since(STAT_WAIT, s_fg.started);
+            s_fg.started = 0;
+        }
+        if (s_fg.usage && result != -1)
+            usage_add(s_fg.usage, &ru);
+    }
+}
+
+// SIGCHLD: collect stops and continues (exits arrive on the pidfds)
+static void handle_child_events(void)
+{
+    for (;;)
+    {
+        siginfo_t info;
+        memset(&info, 0, sizeof info);
+        if (waitid(P_ALL, 0, &info, WSTOPPED | WCONTINUED | WNOHANG) == -1 || info.si_pid == 0)
+            break;
+
+        watch_t *w = *find_slot(info.si_pid);
+        if (!w)
+            continue;
+
+        int stopped = info.si_code == CLD_STOPPED || info.si_code == CLD_TRAPPED;
+        if (stopped)
+            trace_stop(info.si_pid);
+        if (w->kind == WATCH_FOREGROUND)
+        {
+            if (stopped)
+                s_fg.stopped = 1;
+        }
+        else if (w->kind == WATCH_JOB)
+        {
+            if (stopped)
+                job_stopped(info.si_pid);
+            else
+                job_continued(info.si_pid);
+        }
+    }
+
+    if (s_unpolled == 0)
+        return;
+    for (int i = 0; i < EVENTS_WATCH_BUCKETS; i++)
+    {
+        watch_t *w = s_watches[i];
+        while (w)
+        {
+            watch_t *next = w->next;
+            if (w->fd == -1)
+                reap(w);
+            w = next;
+        }
+    }
+}
+
+static void handle_signals(void)
+{
+    struct signalfd_siginfo si;
+    int child_event = 0;
+
+    while (read(s_signal_fd, &si, sizeof si) == sizeof si)
+    {
+        if (si.ssi_signo == SIGCHLD)
+        {
+            child_event = 1;
+            continue;
+        }
+
+        if (si.ssi_signo == SIGINT)
+            s_fg.interrupted = 1;
+        if (g_foreground_pgid > 0)
+        {
+            // Ctrl-C / Ctrl-Z belong to the foreground job, not the shell
+            killpg(g_foreground_pgid, si.ssi_signo);
+        }
+    }
+
+    if (child_event)
+        handle_child_events();
+}
+
+// Expirations missed while busy are folded into one tick
+static void handle_timer(void)
+{
+    uint64_t expirations;
+    if (read(s_timer_fd, &expirations, sizeof expirations) == sizeof expirations && s_tick)
+        s_tick(s_tick_arg);
+}
+
+// One epoll_wait; returns the number of events handled
+static int dispatch(int timeout)
+{
+    ensure_loop();
+
+    struct epoll_event events[EVENTS_MAX_BATCH];
+    int n = epoll_wait(s_epoll, events, EVENTS_MAX_BATCH, timeout);
+    if (n == -1)
+    {
+        if (errno != EINTR)
+            perror("epoll_wait");
+        return 0;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        void *ptr = events[i].data.ptr;
+        if (ptr == &s_input_tag)
+            s_input_ready = 1;
+        else if (ptr == &s_signal_tag)
+            handle_signals();
+        else if (ptr == &s_timer_tag)
+            handle_timer();
+        else
+            reap(ptr);
+    }
+    return n;
+}
+
+int events_init(int input_fd)
+{
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTSTP);
+
+    // Children get an empty mask back (see launch.c)
+    if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1)
+    {
+        perror("sigprocmask");
+        return -1;
+    }
+
+    // Ignore SIGTTOU to avoid being stopped when writing to terminal
+    signal(SIGTTOU, SIG_IGN);
+
+    s_epoll = epoll_create1(EPOLL_CLOEXEC);
+    s_signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (s_epoll == -1 || s_signal_fd == -1)
+    {
+        perror("event loop");
+        return -1;
+    }
+
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = &s_signal_tag};
+    if (epoll_ctl(s_epoll, EPOLL_CTL_ADD, s_signal_fd, &ev) == -1)
+    {
+        perror("epoll_ctl");
+        return -1;
+    }
+
+    // Regular files cannot be polled (EPERM); they are always readable
+    s_input_fd = input_fd;
+    ev.data.ptr = &s_input_tag;
+    s_input_pollable = epoll_ctl(s_epoll, EPOLL_CTL_ADD, input_fd, &ev) == 0;
+    if (s_input_pollable)
+        epoll_ctl(s_epoll, EPOLL_CTL_DEL, input_fd, NULL);
+
+    return 0;
+}
+
+void events_poll(void)
+{
+    while (dispatch(0) == EVENTS_MAX_BATCH)
+        ;
+}
+
+int events_wait_input(void)
+{
+    if (!s_input_pollable)
+    {
+        events_poll();
+        return 0;
+    }
+
+    // Input is in the set only while waiting for it; a hung-up pipe would
+    // otherwise keep waking the foreground waits
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = &s_input_tag};
+    epoll_ctl(s_epoll, EPOLL_CTL_ADD, s_input_fd, &ev);
+
+    s_input_ready = 0;
+    s_fg.interrupted = 0;
+    s_at_prompt = 1;
+    while (!s_input_ready && !s_fg.interrupted)
+    {
+        s_prompt_stale = 0;
+        dispatch(-1);
+
+        if (s_prompt_stale && !s_input_ready)
+        {
+            char p[SHELL_PROMPT_MAX];
+            fflush(stderr);
+            if (prompt_build(p, sizeof p) == 0)
+            {
+                printf("%s", p);
+                fflush(stdout);
+            }
+        }
+    }
+    s_at_prompt = 0;
+
+    epoll_ctl(s_epoll, EPOLL_CTL_DEL, s_input_fd, NULL);
+    return !s_input_ready;
+}
+
+int events_watch_job(pid_t pid)
+{
+    return add_watch(pid, WATCH_JOB, 0) ? 0 : -1;
+}
+
+int events_watch_quiet(pid_t pid, pid_t owner)
+{
+    watch_t *w = add_watch(pid, WATCH_QUIET, 0);
+    if (!w)
+        return -1;
+    w->owner = owner;
+    return 0;
+}
+
+void events_unwatch(pid_t pid)
+{
+    watch_t *w = *find_slot(pid);
+    if (w)
+        remove_watch(w);
+}
+
+int events_set_ticker(void (*tick)(void *arg), void *arg, int interval_ms)
+{
+    if (s_timer_fd != -1)
+    {
+        epoll_ctl(s_epoll, EPOLL_CTL_DEL, s_timer_fd, NULL);
+        close(s_timer_fd);
+        s_timer_fd = -1;
+    }
+    s_tick = tick;
+    s_tick_arg = arg;
+    if (!tick)
+        return 0;
+
+    ensure_loop();
+    s_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct itimerspec period = {
+        .it_interval = {interval_ms / 1000, (interval_ms % 1000) * 1000000L},
+    };
+    period.it_value = period.it_interval;
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = &s_timer_tag};
+    if (s_timer_fd == -1 || timerfd_settime(s_timer_fd, 0, &period, NULL) == -1 ||
+        epoll_ctl(s_epoll, EPOLL_CTL_ADD, s_timer_fd, &ev) == -1)
+    {
+        perror("timerfd");
+        if (s_timer_fd != -1)
+            close(s_timer_fd);
+        s_timer_fd = -1;
+        s_tick = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int events_wait_foreground(const pid_t *pids, int *statuses, int count, job_usage_t *usage)
+{
+    s_fg.statuses = statuses;
+    s_fg.usage = usage;
+    s_fg.started = stats_now();
+    s_fg.remaining = 0;
+    s_fg.stopped = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        statuses[i] = -1;
+        if (pids[i] > 0 && add_watch(pids[i], WATCH_FOREGROUND, i))
+            s_fg.remaining++;
+    }
+
+    while (s_fg.remaining > 0 && !s_fg.stopped)
+        dispatch(-1);
+
+    if (s_fg.stopped)
+    {
+        // What is left of the group becomes a job: the leader is reported
+        // on, the other members are only reaped
+        for (int i = 0; i < count; i++)
+        {
+            watch_t *w = pids[i] > 0 ? *find_slot(pids[i]) : NULL;
+            if (w && w->kind == WATCH_FOREGROUND)
+            {
+                w->kind = WATCH_QUIET;
+                w->owner = g_foreground_pid;
+            }
+        }
+        job_stopped_in_foreground(g_foreground_pid, g_foreground_command, usage);
+    }
+
+    s_fg.statuses = NULL;
+    s_fg.usage = NULL;
+    s_fg.started = 0;
+    return s_fg.stopped;
+}
+
+int events_wait_any(const pid_t *pids, int *statuses, int count)
+{
+    s_fg.statuses = statuses;
+    s_fg.usage = NULL;
+    s_fg.remaining = 0;
+    s_fg.stopped = 0;
+    s_fg.interrupted = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (pids[i] > 0 && statuses[i] == -1 && add_watch(pids[i], WATCH_FOREGROUND, i))
+            s_fg.remaining++;
+    }
+
+    // Stops are not waited out here; the caller only counts completions
+    int running = s_fg.remaining;
+    while (running > 0 && s_fg.remaining == running && !s_fg.interrupted)
+        dispatch(-1);
+
+    s_fg.statuses = NULL;
+    return s_fg.interrupted;
+}
+
+void events_reset_child(int input_fd)
+{
+    // After fork the epoll set, the signalfd and the ticker are still the
+    // parent's
+    close(s_epoll);
+    close(s_signal_fd);
+    if (s_timer_fd != -1)
+        close(s_timer_fd);
+    s_epoll = s_signal_fd = s_timer_fd = -1;
+    s_tick = NULL;
+
+    for (int i = 0; i < EVENTS_WATCH_BUCKETS; i++)
+    {
+        while (s_watches[i])
+        {
+            watch_t *w = s_watches[i];
+            s_watches[i] = w->next;
+            if (w->fd != -1)
+                close(w->fd);
+            free(w);
+        }
+    }
+    s_unpolled = 0;
+    s_fg.statuses = NULL;
+
+    // The new loop is only set up if the child uses it, so a plain builtin
+    // keeps default signal handling and dies on Ctrl-C like any command
+    s_input_fd = input_fd;
+}
+
+/* ############## LLM Generated Code Ends ################ */
@@ -0,0 +1,218 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include "fanout.h"
+#include "launch.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+// Bytes asked of one tee; the pipe holds far less, so this means "all"
+#define FANOUT_CHUNK (1 << 30)
+
+int fanout_open(fanout_t *f, char *const *files, const int *appends, int count)
+{
+    f->count = 0;
+    f->fds = malloc(count * sizeof *f->fds);
+    if (!f->fds)
+    {
+        perror("malloc failed");
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        int fd = launch_open_output(files[i], appends[i]);
+        if (fd == -1)
+        {
+            fanout_close(f);
+            return -1;
+        }
+        f->fds[f->count++] = fd;
+    }
+    return 0;
+}
+
+void fanout_close(fanout_t *f)
+{
+    for (int i = 0; i < f->count; i++)
+        close(f->fds[i]);
+    free(f->fds);
+    f->fds = NULL;
+    f->count = 0;
+}
+
+// Move exactly len bytes from the pipe src into dst.  A dst that takes no
+// splice gets them by read/write; if dst fails for good the bytes are
+// still consumed so the other targets keep going.
+static void drain(int src, int dst, size_t len, int *broken)
+{
+    char buf[8192];
+
+    while (len > 0)
+    {
+        ssize_t n = -1;
+        if (!*broken)
+            n = splice(src, NULL, dst, NULL, len, SPLICE_F_MOVE);
+        if (n > 0)
+        {
+            len -= n;
+            continue;
+        }
+        if (n == -1 && errno == EINTR)
+            continue;
+
+        // No splice into dst (EINVAL), or dst is gone
+        n = read(src, buf, len < sizeof buf ? len : sizeof buf);
+        if (n <= 0)
+            return;
+        len -= n;
+        if (!*broken)
+        {
+            for (ssize_t off = 0; off < n;)
+            {
+                ssize_t w = write(dst, buf + off, n - off);
+                if (w == -1 && errno == EINTR)
+                    continue;
+                if (w <= 0)
+                {
+                    *broken = 1;
+                    break;
+                }
+                off += w;
+            }
+        }
+    }
+}
+
+// The relay without tee: read each chunk once and write it to every
+// target.  A target that fails is skipped for that chunk; the rest go on.
+static void copy_loop(int read_fd, const fanout_t *f)
+{
+    char buf[8192];
+
+    for (;;)
+    {
+        ssize_t n = read(read_fd, buf, sizeof buf);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return;
+
+        for (int i = 0; i < f->count; i++)
+        {
+            for (ssize_t off = 0; off < n;)
+            {
+                ssize_t w = write(f->fds[i], buf + off, n - off);
+                if (w == -1 && errno == EINTR)
+                    continue;
+                if (w <= 0)
+                    break;
+                off += w;
+            }
+        }
+    }
+}
+
+int fanout_relay(int read_fd, const fanout_t *f)
+{
+    int count = f->count;
+
+    // Extra pipes: copies[i] feeds target i; the last target is drained
+    // straight from read_fd
+    int (*copies)[2] = calloc(count, sizeof *copies);
+    int *broken = calloc(count, sizeof *broken);
+    int *keep = malloc((3 * count + 1) * sizeof *keep);
+    if (!copies || !broken || !keep)
+    {
+        perror("malloc failed");
+        copy_loop(read_fd, f);
+        return -1;
+    }
+
+    int pipe_size = fcntl(read_fd, F_GETPIPE_SZ);
+    int nkeep = 0;
+    keep[nkeep++] = read_fd;
+    for (int i = 0; i < count; i++)
+    {
+        keep[nkeep++] = f->fds[i];
+        if (i == count - 1)
+            break;
+        if (pipe2(copies[i], O_CLOEXEC) == -1)
+        {
+            perror("pipe failed");
+            copy_loop(read_fd, f);
+            return -1;
+        }
+        // As large as the source, so one tee always fits in a drained copy
+        if (pipe_size > 0)
+            fcntl(copies[i][1], F_SETPIPE_SZ, pipe_size);
+        keep[nkeep++] = copies[i][0];
+        keep[nkeep++] = copies[i][1];
+    }
+    launch_close_others(keep, nkeep);
+
+    for (;;)
+    {
+        // The first tee waits for data and sets how much this round moves;
+        // the others duplicate exactly that much, since more may arrive
+        ssize_t len = tee(read_fd, copies[0][1], FANOUT_CHUNK, 0);
+        if (len == -1 && errno == EINTR)
+            continue;
+        for (int i = 1; len > 0 && i < count - 1; i++)
+        {
+            ssize_t n;
+            do
+                n = tee(read_fd, copies[i][1], len, 0);
+            while (n == -1 && errno == EINTR);
+            if (n != len)
+            {
+                perror("tee");
+                len = -1;
+            }
+        }
+        if (len <= 0)
+            break;
+
+        for (int i = 0; i < count - 1; i++)
+            drain(copies[i][0], f->fds[i], len, &broken[i]);
+        drain(read_fd, f->fds[count - 1], len, &broken[count - 1]);
+    }
+    return 0;
+}
+
+int fanout_start(fanout_t *f, pid_t *pid)
+{
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) == -1)
+    {
+        perror("pipe failed");
+        fanout_close(f);
+        return -1;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+
+    *pid = fork();
+    if (*pid == 0)
+    {
+        close(fds[1]);
+        _exit(fanout_relay(fds[0], f) == 0 ? 0 : 1);
+    }
+
+    close(fds[0]);
+    fanout_close(f);
+    if (*pid == -1)
+    {
+        perror("fork failed");
+        close(fds[1]);
+        return -1;
+    }
+    return fds[1];
+}
+
+/* ############## LLM Generated Code Ends ################ */
@@ -0,0 +1,784 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+#include "shell.h"
+#include "fastpath.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FASTPATH_HAVE_X86 1
+#endif
+
+/* ############## LLM Generated Code Begins ############## */
+
+#define FASTPATH_BUFFER (128 * 1024)
+#define FASTPATH_CHUNK (1 << 30)    // Per kernel copy call
+
+typedef enum
+{
+    TOOL_CAT,
+    TOOL_HEAD,
+    TOOL_WC
+} tool_t;
+
+typedef struct
+{
+    int lines, words, bytes;    // wc: counts to print (all if none given)
+    long long count;            // head: lines to print
+    char **files;               // Operands in order (in the line arena)
+    int file_count;             // 0: standard input
+} fast_opts_t;
+
+static unsigned char s_buf[FASTPATH_BUFFER] __attribute__((aligned(64)));
+
+// ---------------------------------------------
+// Options: anything not listed here makes the real binary run instead
+// ---------------------------------------------
+
+static int parse_count(const char *s, long long *count)
+{
+    if (!*s)
+        return -1;
+    long long n = 0;
+    for (; *s; s++)
+    {
+        if (*s < '0' || *s > '9' || n > (LLONG_MAX - 9) / 10)
+            return -1;
+        n = n * 10 + (*s - '0');
+    }
+    *count = n;
+    return 0;
+}
+
+// Parse args (argv without argv[0]) the way the tool would; -1 if an
+// option is not supported here
+static int parse_options(tool_t tool, char **args, int n, fast_opts_t *opts)
+{
+    memset(opts, 0, sizeof *opts);
+    opts->count = 10;
+    opts->files = arena_alloc(&g_line_arena, (n + 1) * sizeof(char *));
+    if (!opts->files)
+        return -1;
+
+    int operands_only = 0;
+    for (int i = 0; i < n; i++)
+    {
+        char *arg = args[i];
+        if (operands_only || arg[0] != '-' || arg[1] == '\0')
+        {
+            opts->files[opts->file_count++] = arg;
+            continue;
+        }
+        if (strcmp(arg, "--") == 0)
+        {
+            operands_only = 1;
+            continue;
+        }
+
+        if (tool == TOOL_HEAD)
+        {
+            // -n N, -nN and the obsolete -N
+            if (arg[1] == 'n')
+            {
+                const char *value = arg[2] ? arg + 2 : (i + 1 < n ? args[++i] : "");
+                if (parse_count(value, &opts->count) != 0)
+                    return -1;
+            }
+            else if (parse_count(arg + 1, &opts->count) != 0)
+            {
+                return -1;
+            }
+            continue;
+        }
+
+        // cat takes no options at all
+        if (tool != TOOL_WC || arg[1] == '-')
+            return -1;
+        for (const char *f = arg + 1; *f; f++)
+        {
+            if (*f == 'l')
+                opts->lines = 1;
+            else if (*f == 'w')
+                opts->words = 1;
+            else if (*f == 'c')
+                opts->bytes = 1;
+            else
+                return -1;
+        }
+    }
+
+    if (tool == TOOL_WC && !opts->lines && !opts->words && !opts->bytes)
+        opts->lines = opts->words = opts->bytes = 1;
+    return 0;
+}
+
+static int open_operand(const char *name)
+{
+    return strcmp(name, "-") == 0 ? STDIN_FILENO : open(name, O_RDONLY | O_CLOEXEC);
+}
+
+static void close_operand(int fd)
+{
+    if (fd != STDIN_FILENO)
+        close(fd);
+}
+
+static int write_all(int fd, const void *buf, size_t len)
+{
+    const char *p = buf;
+    while (len > 0)
+    {
+        ssize_t n = write(fd, p, len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+// ---------------------------------------------
+// cat: the kernel moves the bytes where the pair of files allows it
+// ---------------------------------------------
+
+// Whether a kernel copy failed only because it does not handle this pair
+static int copy_unsupported(int err)
+{
+    return err == EINVAL || err == EXDEV || err == ENOSYS || err == EBADF || err == EOPNOTSUPP;
+}
+
+// Copy the rest of in to out; each method continues at the file offsets
+// where the previous one stopped.  Returns -1 with errno set.
+static int copy_fd(int in, int out, const struct stat *in_st, const struct stat *out_st)
+{
+    ssize_t n;
+
+    // copy_file_range: file to file, shared extents where the fs can
+    if (S_ISREG(in_st->st_mode) && S_ISREG(out_st->st_mode))
+    {
+        while ((n = copy_file_range(in, NULL, out, NULL, FASTPATH_CHUNK, 0)) != 0)
+        {
+            if (n > 0 || errno == EINTR)
+                continue;
+            if (!copy_unsupported(errno))
+                return -1;
+            break;
+        }
+        if (n == 0)
+            return 0;
+    }
+
+    // splice: either end is a pipe
+    if (S_ISFIFO(in_st->st_mode) || S_ISFIFO(out_st->st_mode))
+    {
+        while ((n = splice(in, NULL, out, NULL, FASTPATH_CHUNK, SPLICE_F_MOVE | SPLICE_F_MORE)) != 0)
+        {
+            if (n > 0 || errno == EINTR)
+                continue;
+            if (!copy_unsupported(errno))
+                return -1;
+            break;
+        }
+        if (n == 0)
+            return 0;
+    }
+
+    // sendfile: from a regular file to anything (a terminal)
+    if (S_ISREG(in_st->st_mode))
+    {
+        while ((n = sendfile(out, in, NULL, FASTPATH_CHUNK)) != 0)
+        {
+            if (n > 0 || errno == EINTR)
+                continue;
+            if (!copy_unsupported(errno))
+                return -1;
+            break;
+        }
+        if (n == 0)
+            return 0;
+    }
+
+    // O_APPEND outputs, character devices: copy by hand
+    while ((n = read(in, s_buf, sizeof s_buf)) != 0)
+    {
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1 || write_all(out, s_buf, n) == -1)
+            return -1;
+    }
+    return 0;
+}
+
+static int fast_cat(int argc, char **argv)
+{
+    fast_opts_t opts;
+    char *stdin_only[] = {"-"};
+    int result = 0;
+
+    if (parse_options(TOOL_CAT, argv + 1, argc - 1, &opts) != 0)
+        return 1;
+
+    struct stat out_st;
+    if (fstat(STDOUT_FILENO, &out_st) == -1)
+    {
+        perror("cat: standard output");
+        return 1;
+    }
+
+    // Anything the shell still has buffered goes first
+    fflush(stdout);
+
+    char **names = opts.file_count ? opts.files : stdin_only;
+    int count = opts.file_count ? opts.file_count : 1;
+    for (int i = 0; i < count; i++)
+    {
+        const char *name = names[i];
+        int fd = open_operand(name);
+        struct stat in_st;
+        if (fd == -1 || fstat(fd, &in_st) == -1)
+        {
+            fprintf(stderr, "cat: %s: %s\n", name, strerror(errno));
+            if (fd != -1)
+                close_operand(fd);
+            result = 1;
+            continue;
+        }
+
+        // Appending a file to itself would never reach its end
+        if (S_ISREG(in_st.st_mode) && in_st.st_dev == out_st.st_dev && in_st.st_ino == out_st.st_ino &&
+            lseek(fd, 0, SEEK_CUR) < in_st.st_size)
+        {
+            fprintf(stderr, "cat: %s: input file is output file\n", name);
+            close_operand(fd);
+            result = 1;
+            continue;
+        }
+
+        if (copy_fd(fd, STDOUT_FILENO, &in_st, &out_st) == -1)
+        {
+            fprintf(stderr, "cat: %s: %s\n", name, strerror(errno));
+            result = 1;
+        }
+        close_operand(fd);
+    }
+    return result;
+}
+
+// ---------------------------------------------
+// head -n: write up to the count-th newline
+// ---------------------------------------------
+
+// Returns 0, or -1 after a read error (reported)
+static int head_fd(int fd, const char *name, long long count)
+{
+    while (count > 0)
+    {
+        ssize_t n = read(fd, s_buf, sizeof s_buf);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1)
+        {
+            fprintf(stderr, "head: error reading '%s': %s\n", name, strerror(errno));
+            return -1;
+        }
+        if (n == 0)
+            break;
+
+        // memchr is vectorized in libc; stop at the last line wanted
+        const unsigned char *p = s_buf, *end = s_buf + n;
+        while (count > 0 && p < end)
+        {
+            const unsigned char *nl = memchr(p, '\n', end - p);
+            if (!nl)
+                break;
+            p = nl + 1;
+            count--;
+        }
+        if (write_all(STDOUT_FILENO, s_buf, count > 0 ? (size_t)n : (size_t)(p - s_buf)) == -1)
+            return -1;
+    }
+    return 0;
+}
+
+static int fast_head(int argc, char **argv)
+{
+    fast_opts_t opts;
+    if (parse_options(TOOL_HEAD, argv + 1, argc - 1, &opts) != 0)
+        return 1;
+
+    fflush(stdout);
+    if (opts.file_count == 0)
+        return head_fd(STDIN_FILENO, "standard input", opts.count) == 0 ? 0 : 1;
+
+    int result = 0;
+    for (int i = 0; i < opts.file_count; i++)
+    {
+        const char *name = opts.files[i];
+        int fd = open_operand(name);
+        if (fd == -1)
+        {
+            fprintf(stderr, "head: cannot open '%s' for reading: %s\n", name, strerror(errno));
+            result = 1;
+            continue;
+        }
+
+        // Several files get a header each, as head prints them
+        const char *shown = fd == STDIN_FILENO ? "standard input" : name;
+        if (opts.file_count > 1)
+        {
+            char header[PATH_MAX + 16];
+            int len = snprintf(header, sizeof header, "%s==> %s <==\n", i > 0 ? "\n" : "", shown);
+            write_all(STDOUT_FILENO, header, len < (int)sizeof header ? (size_t)len : sizeof header - 1);
+        }
+        if (head_fd(fd, shown, opts.count) != 0)
+            result = 1;
+        close_operand(fd);
+    }
+    return result;
+}
+
+// ---------------------------------------------
+// wc: newline and word-start counting kernels
+// ---------------------------------------------
+
+// Words as wc counts them in the C locale: a word starts at a printable
+// character after white space (or at the start); other bytes (controls,
+// bytes >= 0x7f) neither start nor end one
+typedef struct
+{
+    unsigned long long lines, words, bytes;
+    int in_word;                // A word is open at the last byte counted
+} wc_counts_t;
+
+// Count lines (and word starts if words) of len bytes at p into c
+typedef void (*count_fn_t)(const unsigned char *p, size_t len, int words, wc_counts_t *c);
+
+// Space and \t \n \v \f \r
+static int is_wc_space(unsigned char ch)
+{
+    return ch == ' ' || (unsigned char)(ch - '\t') <= '\r' - '\t';
+}
+
+// Printable and not a space: '!' to '~'
+static int is_wc_graph(unsigned char ch)
+{
+    return (unsigned char)(ch - '!') <= '~' - '!';
+}
+
+static void count_scalar(const unsigned char *p, size_t len, int words, wc_counts_t *c)
+{
+    if (!words)
+    {
+        unsigned long long lines = 0;
+        for (size_t i = 0; i < len; i++)
+            lines += p[i] == '\n';
+        c->lines += lines;
+        return;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        c->lines += p[i] == '\n';
+        if (is_wc_space(p[i]))
+        {
+            c->in_word = 0;
+        }
+        else if (is_wc_graph(p[i]))
+        {
+            c->words += !c->in_word;
+            c->in_word = 1;
+        }
+    }
+}
+
+#ifdef FASTPATH_HAVE_X86
+
+// Word starts in a block of width bytes, given the bitmaps of its spaces
+// and printable characters.  Each space arms the bit after it; adding the
+// mask of the other bytes carries that bit across a run of them to the
+// next space or printable, and a printable reached armed starts a word.
+// The carry out of the block arms the next one.
+static inline unsigned long long word_starts(uint32_t space, uint32_t graph, int *in_word, int width)
+{
+    uint64_t other = ~(uint64_t)(space | graph) & (((uint64_t)1 << width) - 1);
+    uint64_t armed = ((uint64_t)space << 1) | (*in_word ? 0 : 1);
+    uint64_t reached = other + armed;
+    *in_word = !((reached >> width) & 1);
+    return (unsigned long long)__builtin_popcountll(reached & graph);
+}
+
+// ---------------------------------------------
+// SSE2: 16 bytes per compare
+// ---------------------------------------------
+
+static void count_sse2(const unsigned char *p, size_t len, int words, wc_counts_t *c)
+{
+    const __m128i nl = _mm_set1_epi8('\n'), sp = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t'), tab_span = _mm_set1_epi8('\r' - '\t');
+    const __m128i bang = _mm_set1_epi8('!'), graph_span = _mm_set1_epi8('~' - '!');
+    unsigned long long lines = 0, word_count = 0;
+    int in_word = c->in_word;
+    size_t i = 0;
+
+    if (!words)
+    {
+        // Newline matches are -1 per byte; subtracting them counts up to
+        // 255 blocks in byte lanes, summed with SAD before they overflow
+        while (i + 16 <= len)
+        {
+            __m128i acc = _mm_setzero_si128();
+            for (int n = 0; n < 255 && i + 16 <= len; n++, i += 16)
+            {
+                __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+                acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(v, nl));
+            }
+            __m128i sums = _mm_sad_epu8(acc, _mm_setzero_si128());
+            lines += (unsigned long long)_mm_cvtsi128_si64(sums) +
+                     (unsigned long long)_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+        }
+    }
+
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        lines += __builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)));
+
+        // Ranges as unsigned compares: x - lo <= span <=> min(x - lo, span) == x - lo
+        __m128i off = _mm_sub_epi8(v, tab);
+        __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(_mm_min_epu8(off, tab_span), off));
+        off = _mm_sub_epi8(v, bang);
+        __m128i graph = _mm_cmpeq_epi8(_mm_min_epu8(off, graph_span), off);
+        word_count += word_starts((uint32_t)_mm_movemask_epi8(ws), (uint32_t)_mm_movemask_epi8(graph),
+                                  &in_word, 16);
+    }
+
+    c->lines += lines;
+    c->words += word_count;
+    c->in_word = in_word;
+    count_scalar(p + i, len - i, words, c);
+}
+
+// ---------------------------------------------
+// AVX2: 32 bytes per compare
+// ---------------------------------------------
+
+__attribute__((target("avx2,popcnt"))) static void count_avx2(const unsigned char *p, size_t len,
+                                                               int words, wc_counts_t *c)
+{
+    const __m256i nl = _mm256_set1_epi8('\n'), sp = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t'), tab_span = _mm256_set1_epi8('\r' - '\t');
+    const __m256i bang = _mm256_set1_epi8('!'), graph_span = _mm256_set1_epi8('~' - '!');
+    unsigned long long lines = 0, word_count = 0;
+    int in_word = c->in_word;
+    size_t i = 0;
+
+    if (!words)
+    {
+        while (i + 32 <= len)
+        {
+            __m256i acc = _mm256_setzero_si256();
+            for (int n = 0; n < 255 && i + 32 <= len; n++, i += 32)
+            {
+                __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+                acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(v, nl));
+            }
+            __m256i sums = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+            lines += (unsigned long long)_mm256_extract_epi64(sums, 0) + (unsigned long long)_mm256_extract_epi64(sums, 1) +
+                     (unsigned long long)_mm256_extract_epi64(sums, 2) + (unsigned long long)_mm256_extract_epi64(sums, 3);
+        }
+    }
+
+    for (; i + 32 <= len; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        lines += __builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl)));
+
+        __m256i off = _mm256_sub_epi8(v, tab);
+        __m256i ws = _mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(_mm256_min_epu8(off, tab_span), off));
+        off = _mm256_sub_epi8(v, bang);
+        __m256i graph = _mm256_cmpeq_epi8(_mm256_min_epu8(off, graph_span), off);
+        word_count += word_starts((uint32_t)_mm256_movemask_epi8(ws), (uint32_t)_mm256_movemask_epi8(graph),
+                                  &in_word, 32);
+    }
+
+    c->lines += lines;
+    c->words += word_count;
+    c->in_word = in_word;
+    count_scalar(p + i, len - i, words, c);
+}
+
+#endif // FASTPATH_HAVE_X86
+
+// ---------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------
+
+static count_fn_t s_count = NULL;
+static const char *s_impl_name = "scalar";
+static int s_disabled = 0;
+
+static void fastpath_select(void)
+{
+    const char *forced = getenv("SHELL_FASTPATH");
+
+    s_count = count_scalar;
+    s_impl_name = "scalar";
+    s_disabled = forced && strcmp(forced, "off") == 0;
+
+#ifdef FASTPATH_HAVE_X86
+    if (forced && strcmp(forced, "scalar") == 0)
+        return;
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") &&
+        !(forced && strcmp(forced, "sse2") == 0))
+    {
+        s_count = count_avx2;
+        s_impl_name = "avx2";
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        s_count = count_sse2;
+        s_impl_name = "sse2";
+    }
+#endif
+}
+
+const char *fastpath_impl_name(void)
+{
+    if (!s_count)
+        fastpath_select();
+    return s_impl_name;
+}
+
+// ---------------------------------------------
+// wc
+// ---------------------------------------------
+
+// Count fd into c; -1 after a read error (reported)
+static int wc_fd(int fd, const char *name, const fast_opts_t *opts, wc_counts_t *c)
+{
+    memset(c, 0, sizeof *c);
+
+    // Bytes alone of a regular file come from its size, as wc does
+    struct stat st;
+    if (!opts->lines && !opts->words && fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+    {
+        off_t pos = lseek(fd, 0, SEEK_CUR);
+        if (pos != -1)
+        {
+            c->bytes = st.st_size > pos ? (unsigned long long)(st.st_size - pos) : 0;
+            return 0;
+        }
+    }
+
+    int counting = opts->lines || opts->words;
+    for (;;)
+    {
+        ssize_t n = read(fd, s_buf, sizeof s_buf);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1)
+        {
+            fprintf(stderr, "wc: %s: %s\n", name, strerror(errno));
+            return -1;
+        }
+        if (n == 0)
+            return 0;
+        c->bytes += n;
+        if (counting)
+            s_count(s_buf, n, opts->words, c);
+    }
+}
+
+static void wc_print(const fast_opts_t *opts, const wc_counts_t *c, int width, const char *name)
+{
+    char line[PATH_MAX + 96];
+    int len = 0;
+    const unsigned long long values[] = {c->lines, c->words, c->bytes};
+    const int shown[] = {opts->lines, opts->words, opts->bytes};
+
+    for (int i = 0; i < 3; i++)
+    {
+        if (shown[i])
+            len += snprintf(line + len, sizeof line - len, "%s%*llu", len ? " " : "", width, values[i]);
+    }
+    if (name)
+        len += snprintf(line + len, sizeof line - len, " %s", name);
+    if (len >= (int)sizeof line - 1)
+        len = sizeof line - 2;
+    line[len++] = '\n';
+    write_all(STDOUT_FILENO, line, len);
+}
+
+// Column width as wc picks it: one column of one input is not padded;
+// otherwise wide enough for the regular files' total size, and at least
+// 7 when an input is not a regular file (its size is unknown)
+static int wc_width(const fast_opts_t *opts)
+{
+    if (opts->lines + opts->words + opts->bytes == 1 && opts->file_count <= 1)
+        return 1;
+
+    int width = 1, minimum = 1;
+    unsigned long long total = 0;
+    int count = opts->file_count ? opts->file_count : 1;
+    for (int i = 0; i < count; i++)
+    {
+        struct stat st;
+        const char *name = opts->file_count ? opts->files[i] : "-";
+        int failed = strcmp(name, "-") == 0 ? fstat(STDIN_FILENO, &st) : stat(name, &st);
+        if (failed)
+        {
+            if (i == 0)
+                return 1;
+            continue;
+        }
+        if (!S_ISREG(st.st_mode))
+            minimum = 7;
+        else if (st.st_size > 0)
+            total += st.st_size;
+    }
+    for (; total >= 10; total /= 10)
+        width++;
+    return width < minimum ? minimum : width;
+}
+
+static int fast_wc(int argc, char **argv)
+{
+    fast_opts_t opts;
+    if (parse_options(TOOL_WC, argv + 1, argc - 1, &opts) != 0)
+        return 1;
+    if (!s_count)
+        fastpath_select();
+
+    fflush(stdout);
+    int width = wc_width(&opts);
+    wc_counts_t c;
+
+    if (opts.file_count == 0)
+    {
+        if (wc_fd(STDIN_FILENO, "standard input", &opts, &c) != 0)
+            return 1;
+        wc_print(&opts, &c, width, NULL);
+        return 0;
+    }
+
+    int result = 0;
+    wc_counts_t total = {0, 0, 0, 0};
+    for (int i = 0; i < opts.file_count; i++)
+    {
+        const char *name = opts.files[i];
+        int fd = open_operand(name);
+        if (fd == -1)
+        {
+            fprintf(stderr, "wc: %s: %s\n", name, strerror(errno));
+            result = 1;
+            continue;
+        }
+
+        // A read error still prints what was counted, as wc does
+        if (wc_fd(fd, name, &opts, &c) != 0)
+            result = 1;
+        close_operand(fd);
+
+        wc_print(&opts, &c, width, name);
+        total.lines += c.lines;
+        total.words += c.words;
+        total.bytes += c.bytes;
+    }
+    if (opts.file_count > 1)
+        wc_print(&opts, &total, width, "total");
+    return result;
+}
+
+// ---------------------------------------------
+// Registry
+// ---------------------------------------------
+
+static const builtin_t s_fastpaths[] = {
+    {"cat", fast_cat, BUILTIN_FORKABLE},
+    {"head", fast_head, BUILTIN_FORKABLE},
+    {"wc", fast_wc, BUILTIN_FORKABLE},
+};
+
+static tool_t tool_of(const builtin_t *b)
+{
+    return (tool_t)(b - s_fastpaths);
+}
+
+static const builtin_t *find_tool(const char *name)
+{
+    for (size_t i = 0; i < sizeof s_fastpaths / sizeof s_fastpaths[0]; i++)
+    {
+        if (strcmp(s_fastpaths[i].name, name) == 0)
+            return &s_fastpaths[i];
+    }
+    return NULL;
+}
+
+// Whether commands run in the C locale, whose character classes the word
+// count implements (LC_ALL, then LC_CTYPE, then LANG decide)
+static int c_locale(void)
+{
+    const char *names[] = {"LC_ALL", "LC_CTYPE", "LANG"};
+    for (int i = 0; i < 3; i++)
+    {
+        const char *value = getenv(names[i]);
+        if (value && *value)
+            return strcmp(value, "C") == 0 || strcmp(value, "POSIX") == 0;
+    }
+    return 1;
+}
+
+const builtin_t *fastpath_lookup(const char *name, char **args, int arg_count)
+{
+    if (!s_count)
+        fastpath_select();
+    if (s_disabled)
+        return NULL;
+
+    const builtin_t *b = find_tool(name);
+    fast_opts_t opts;
+    if (!b || parse_options(tool_of(b), args, arg_count, &opts) != 0)
+        return NULL;
+    if (opts.words && !c_locale())
+        return NULL;
+    return b;
+}
+
+int fastpath_inputs_regular(const char *name, char **args, int arg_count, int *reads_stdin)
+{
+    const builtin_t *b = find_tool(name);
+    fast_opts_t opts;
+    *reads_stdin = 0;
+    if (!b || parse_options(tool_of(b), args, arg_count, &opts) != 0)
+        return 0;
+
+    if (opts.file_count == 0)
+    {
+        *reads_stdin = 1;
+        return 1;
+    }
+
+    for (int i = 0; i < opts.file_count; i++)
+    {
+        const char *file = opts.files[i];
+        struct stat st;
+        if (strcmp(file, "-") == 0)
+            *reads_stdin = 1;
+        else if (stat(file, &st) == 0 && !S_ISREG(st.st_mode))
+            return 0;
+    }
+    return 1;
+}
+
+/* ############## LLM Generated Code Ends ################ */
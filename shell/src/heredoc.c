@@ -0,0 +1,174 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include "shell.h"
+#include "heredoc.h"
+#include "events.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+// Bodies of the current line's here-documents, by here_index - 1.
+// s_owner is the tree they were read for and s_running the one being
+// executed; only when they match do the indices refer to these bodies.
+static char **s_bodies = NULL;
+static size_t *s_lengths = NULL;
+static int s_count = 0;
+static const sequential_commands_t *s_owner = NULL;
+static const sequential_commands_t *s_running = NULL;
+
+// Read lines into one body up to the delimiter
+static int collect_body(const char *delimiter, line_reader_t *reader, int index)
+{
+    size_t len = 0, capacity = 0;
+    char *body = NULL;
+
+    for (;;)
+    {
+        if (!g_batch_mode)
+        {
+            printf("> ");
+            fflush(stdout);
+
+            // SIGINT is blocked, so a read() here could not be cancelled
+            if (!reader_has_line(reader) && events_wait_input())
+            {
+                printf("\n");
+                s_count = 0;
+                return HEREDOC_INTERRUPTED;
+            }
+        }
+
+        char *line;
+        ssize_t n = reader_next_line(reader, &line);
+        if (n == -2 && errno == EINTR)
+            continue;
+        if (n < 0)
+        {
+            s_bodies[index] = body;
+            s_lengths[index] = len;
+            return -1;
+        }
+        if (strcmp(line, delimiter) == 0)
+            break;
+
+        if (len + n + 1 > capacity)
+        {
+            size_t new_capacity = capacity ? capacity * 2 : 256;
+            while (new_capacity < len + n + 1)
+                new_capacity *= 2;
+            char *tmp = arena_realloc(&g_line_arena, body, capacity, new_capacity);
+            if (!tmp)
+            {
+                perror("malloc failed");
+                break;
+            }
+            body = tmp;
+            capacity = new_capacity;
+        }
+        memcpy(body + len, line, n);
+        body[len + n] = '\n';
+        len += n + 1;
+    }
+
+    s_bodies[index] = body;
+    s_lengths[index] = len;
+    return 0;
+}
+
+int heredoc_collect(const sequential_commands_t *seq_cmds, line_reader_t *reader)
+{
+    // The previous line's bodies went with the arena reset
+    s_count = 0;
+    s_owner = seq_cmds;
+    if (seq_cmds->here_doc_count == 0)
+        return 0;
+
+    int count = seq_cmds->here_doc_count;
+    s_bodies = arena_alloc(&g_line_arena, count * sizeof *s_bodies);
+    s_lengths = arena_alloc(&g_line_arena, count * sizeof *s_lengths);
+    if (!s_bodies || !s_lengths)
+    {
+        perror("malloc failed");
+        return -1;
+    }
+    memset(s_bodies, 0, count * sizeof *s_bodies);
+    memset(s_lengths, 0, count * sizeof *s_lengths);
+    s_count = count;
+
+    for (int i = 0; i < count; i++)
+    {
+        int result = collect_body(seq_cmds->here_docs[i], reader, i);
+        if (result != 0)
+            return result;
+    }
+    return 0;
+}
+
+const sequential_commands_t *heredoc_enter(const sequential_commands_t *seq_cmds)
+{
+    const sequential_commands_t *previous = s_running;
+    s_running = seq_cmds;
+    return previous;
+}
+
+void heredoc_leave(const sequential_commands_t *previous)
+{
+    s_running = previous;
+}
+
+static int write_all(int fd, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        data += n;
+        len -= n;
+    }
+    return 0;
+}
+
+int heredoc_open(const parsed_command_t *cmd)
+{
+    int fd = memfd_create(cmd->here_string ? "herestring" : "heredoc",
+                          MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd == -1)
+    {
+        perror("memfd_create");
+        return -1;
+    }
+
+    // A line replayed without its following lines (log execute, parallel)
+    // has no body: the input is empty
+    int failed;
+    if (cmd->here_string)
+    {
+        failed = write_all(fd, cmd->here_string, strlen(cmd->here_string)) != 0 ||
+                 write_all(fd, "\n", 1) != 0;
+    }
+    else
+    {
+        int i = cmd->here_index - 1;
+        failed = s_running == s_owner && i >= 0 && i < s_count && s_bodies[i] &&
+                 write_all(fd, s_bodies[i], s_lengths[i]) != 0;
+    }
+
+    if (failed ||
+        fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1 ||
+        lseek(fd, 0, SEEK_SET) == -1)
+    {
+        perror("heredoc");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* ############## LLM Generated Code Ends ################ */
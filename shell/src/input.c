@@ -0,0 +1,106 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include "input.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+int reader_init(line_reader_t *reader, int fd, size_t cap)
+{
+    memset(reader, 0, sizeof(*reader));
+    reader->fd = fd;
+    reader->buf = malloc(cap);
+    if (!reader->buf)
+        return -1;
+    reader->cap = cap;
+    return 0;
+}
+
+void reader_destroy(line_reader_t *reader)
+{
+    free(reader->buf);
+    memset(reader, 0, sizeof(*reader));
+    reader->fd = -1;
+}
+
+int reader_has_line(const line_reader_t *reader)
+{
+    size_t avail = reader->len - reader->start;
+    if (avail == 0)
+        return 0;
+    return reader->eof || memchr(reader->buf + reader->start, '\n', avail) != NULL;
+}
+
+// Make room for more input: slide the partial line to the front, and grow
+// the buffer only when a single line fills all of it.  Always leaves at
+// least one byte to read into plus one spare for a terminator.
+static int reader_make_room(line_reader_t *reader)
+{
+    if (reader->start > 0)
+    {
+        memmove(reader->buf, reader->buf + reader->start, reader->len - reader->start);
+        reader->len -= reader->start;
+        reader->start = 0;
+    }
+
+    if (reader->cap - reader->len < 2)
+    {
+        char *tmp = realloc(reader->buf, reader->cap * 2);
+        if (!tmp)
+            return -1;
+        reader->buf = tmp;
+        reader->cap *= 2;
+    }
+    return 0;
+}
+
+ssize_t reader_next_line(line_reader_t *reader, char **line)
+{
+    size_t scanned = 0; // Bytes of the pending line already searched
+
+    while (1)
+    {
+        char *begin = reader->buf + reader->start;
+        size_t avail = reader->len - reader->start;
+        char *newline = memchr(begin + scanned, '\n', avail - scanned);
+
+        if (newline)
+        {
+            *newline = '\0';
+            reader->start += (newline - begin) + 1;
+            *line = begin;
+            return newline - begin;
+        }
+
+        if (reader->eof)
+        {
+            if (avail == 0)
+                return -1;
+
+            // Final line without a newline; there is always room for the
+            // terminator because reader_make_room runs before every read
+            begin[avail] = '\0';
+            reader->start = reader->len;
+            *line = begin;
+            return (ssize_t)avail;
+        }
+
+        scanned = avail;
+        if (reader_make_room(reader) != 0)
+        {
+            errno = ENOMEM;
+            return -2;
+        }
+
+        // Keep one byte spare for the terminator of an unterminated last line
+        ssize_t n = read(reader->fd, reader->buf + reader->len, reader->cap - reader->len - 1);
+        if (n < 0)
+            return -2;
+        if (n == 0)
+            reader->eof = 1;
+        reader->len += n;
+    }
+}
+
+/* ############## LLM Generated Code Ends ################ */
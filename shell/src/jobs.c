@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "shell.h"
+#include "jobs.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+static background_job_t **s_by_pid = NULL;
+static background_job_t **s_by_id = NULL;
+static size_t s_buckets = 0;        // Power of two
+
+static background_job_t *s_head = NULL, *s_tail = NULL;
+static int s_count = 0;
+static int s_next_job_id = 1;
+
+static background_job_t **s_sorted = NULL;
+static int s_sorted_cap = 0;
+
+static size_t pid_bucket(pid_t pid)
+{
+    return (size_t)pid & (s_buckets - 1);
+}
+
+static size_t id_bucket(int job_id)
+{
+    return (size_t)job_id & (s_buckets - 1);
+}
+
+// (Re)build both hash tables with the given number of buckets
+static int rehash(size_t buckets)
+{
+    background_job_t **by_pid = calloc(buckets, sizeof *by_pid);
+    background_job_t **by_id = calloc(buckets, sizeof *by_id);
+    if (!by_pid || !by_id)
+    {
+        free(by_pid);
+        free(by_id);
+        return -1;
+    }
+
+    free(s_by_pid);
+    free(s_by_id);
+    s_by_pid = by_pid;
+    s_by_id = by_id;
+    s_buckets = buckets;
+
+    for (background_job_t *job = s_head; job; job = job->next)
+    {
+        size_t b = pid_bucket(job->pid);
+        job->pid_next = s_by_pid[b];
+        s_by_pid[b] = job;
+
+        b = id_bucket(job->job_id);
+        job->id_next = s_by_id[b];
+        s_by_id[b] = job;
+    }
+    return 0;
+}
+
+// Sorted-index order: command, then job id
+static int compare_jobs(const background_job_t *a, const background_job_t *b)
+{
+    int c = strcmp(a->command, b->command);
+    if (c != 0)
+        return c;
+    return (a->job_id > b->job_id) - (a->job_id < b->job_id);
+}
+
+// First position in s_sorted not ordered before job
+static int sorted_position(const background_job_t *job)
+{
+    int lo = 0, hi = s_count;
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (compare_jobs(s_sorted[mid], job) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void init_background_jobs(void)
+{
+    if (rehash(JOBS_INITIAL_BUCKETS) != 0)
+    {
+        perror("malloc failed");
+    }
+    s_next_job_id = 1;
+}
+
+background_job_t *jobs_add(pid_t pid, const char *command)
+{
+    // Grow before inserting so every index has room
+    if (s_count >= (int)s_buckets &&
+        rehash(s_buckets ? s_buckets * 2 : JOBS_INITIAL_BUCKETS) != 0)
+    {
+        return NULL;
+    }
+    if (s_count == s_sorted_cap)
+    {
+        int cap = s_sorted_cap ? s_sorted_cap * 2 : JOBS_INITIAL_BUCKETS;
+        background_job_t **sorted = realloc(s_sorted, cap * sizeof *sorted);
+        if (!sorted)
+            return NULL;
+        s_sorted = sorted;
+        s_sorted_cap = cap;
+    }
+
+    background_job_t *job = calloc(1, sizeof *job);
+    if (!job)
+        return NULL;
+
+    job->job_id = s_next_job_id++;
+    job->pid = pid;
+    job->is_active = 1;
+    job->state = PROCESS_RUNNING;
+
+    // Copy command name (truncate if too long)
+    strncpy(job->command, command, sizeof(job->command) - 1);
+    job->command[sizeof(job->command) - 1] = '\0';
+
+    size_t b = pid_bucket(pid);
+    job->pid_next = s_by_pid[b];
+    s_by_pid[b] = job;
+
+    b = id_bucket(job->job_id);
+    job->id_next = s_by_id[b];
+    s_by_id[b] = job;
+
+    // Job ids only grow, so the new job goes at the tail
+    job->prev = s_tail;
+    if (s_tail)
+        s_tail->next = job;
+    else
+        s_head = job;
+    s_tail = job;
+
+    int pos = sorted_position(job);
+    memmove(&s_sorted[pos + 1], &s_sorted[pos], (s_count - pos) * sizeof *s_sorted);
+    s_sorted[pos] = job;
+
+    s_count++;
+    return job;
+}
+
+void jobs_remove(background_job_t *job)
+{
+    background_job_t **slot = &s_by_pid[pid_bucket(job->pid)];
+    while (*slot != job)
+        slot = &(*slot)->pid_next;
+    *slot = job->pid_next;
+
+    slot = &s_by_id[id_bucket(job->job_id)];
+    while (*slot != job)
+        slot = &(*slot)->id_next;
+    *slot = job->id_next;
+
+    if (job->prev)
+        job->prev->next = job->next;
+    else
+        s_head = job->next;
+    if (job->next)
+        job->next->prev = job->prev;
+    else
+        s_tail = job->prev;
+
+    int pos = sorted_position(job);
+    memmove(&s_sorted[pos], &s_sorted[pos + 1], (s_count - pos - 1) * sizeof *s_sorted);
+
+    s_count--;
+    free(job);
+}
+
+background_job_t *jobs_find_pid(pid_t pid)
+{
+    if (!s_buckets)
+        return NULL;
+
+    background_job_t *job = s_by_pid[pid_bucket(pid)];
+    while (job && job->pid != pid)
+        job = job->pid_next;
+    return job;
+}
+
+background_job_t *jobs_find_id(int job_id)
+{
+    if (!s_buckets)
+        return NULL;
+
+    background_job_t *job = s_by_id[id_bucket(job_id)];
+    while (job && job->job_id != job_id)
+        job = job->id_next;
+    return job && job->is_active ? job : NULL;
+}
+
+background_job_t *jobs_most_recent(void)
+{
+    // Only a job in the foreground is inactive, so this stops at once
+    background_job_t *job = s_tail;
+    while (job && !job->is_active)
+        job = job->prev;
+    return job;
+}
+
+background_job_t *jobs_first(void)
+{
+    return s_head;
+}
+
+background_job_t *const *jobs_by_command(int *count)
+{
+    *count = s_count;
+    return s_sorted;
+}
+
+/* ############## LLM Generated Code Ends ################ */
@@ -0,0 +1,281 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <spawn.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include "launch.h"
+#include "pathcache.h"
+#include "stats.h"
+#include "fanout.h"
+#include "zygote.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+extern char **environ;
+
+int launch_open_input(const char *filename)
+{
+    uint64_t start = stats_now();
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    stats_since(STAT_REDIRECT_IN, start);
+    if (fd == -1)
+    {
+        fprintf(stderr, "No such file or directory\n");
+    }
+    return fd;
+}
+
+static int compare_fds(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+void launch_close_others(int *keep, int count)
+{
+    qsort(keep, count, sizeof *keep, compare_fds);
+
+    unsigned int next = 3;
+    for (int i = 0; i < count; i++)
+    {
+        if (keep[i] > (int)next)
+            close_range(next, keep[i] - 1, 0);
+        if (keep[i] >= (int)next)
+            next = keep[i] + 1;
+    }
+    close_range(next, ~0U, 0);
+}
+
+int launch_open_output(const char *filename, int append_mode)
+{
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append_mode ? O_APPEND : O_TRUNC);
+    uint64_t start = stats_now();
+    int fd = open(filename, flags, 0644);
+    stats_since(STAT_REDIRECT_OUT, start);
+    if (fd == -1)
+    {
+        printf("Unable to create file for writing\n");
+    }
+    return fd;
+}
+
+// Several outputs: fork a host into the group that spawns the command
+// with its stdout on a pipe and relays the pipe to every target.  Errors
+// that launch_process reports are checked here first, in the shell.
+static pid_t launch_fanout(const launch_spec_t *spec)
+{
+    if (!path_cache_lookup(spec->argv[0]))
+    {
+        printf("Command not found!\n");
+        return -1;
+    }
+
+    int in_fd = -1;
+    if (spec->input_file && (in_fd = launch_open_input(spec->input_file)) == -1)
+        return -1;
+
+    fanout_t targets;
+    int fds[2] = {-1, -1};
+    if (fanout_open(&targets, spec->outputs, spec->output_appends, spec->output_count) != 0 ||
+        pipe2(fds, O_CLOEXEC) == -1)
+    {
+        if (targets.fds)
+        {
+            perror("pipe failed");
+            fanout_close(&targets);
+        }
+        if (in_fd != -1)
+            close(in_fd);
+        return -1;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+
+    uint64_t start = stats_now();
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        if (spec->pgid == LAUNCH_NEW_GROUP)
+            setpgid(0, 0);
+        else if (spec->pgid != LAUNCH_SAME_GROUP)
+            setpgid(0, spec->pgid);
+
+        // Stops and Ctrl-C take the host along with the command
+        sigset_t empty;
+        sigemptyset(&empty);
+        sigprocmask(SIG_SETMASK, &empty, NULL);
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTSTP, SIG_DFL);
+
+        launch_spec_t inner = *spec;
+        inner.stdin_fd = in_fd != -1 ? in_fd : spec->stdin_fd;
+        inner.input_file = NULL;
+        inner.stdout_fd = fds[1];
+        inner.output_file = NULL;
+        inner.output_count = 0;
+        inner.pgid = getpgrp();
+
+        pid_t child = launch_process(&inner);
+        close(fds[1]);
+        if (child == -1)
+            _exit(127);
+
+        int relayed = fanout_relay(fds[0], &targets);
+
+        int status;
+        while (waitpid(child, &status, 0) == -1 && errno == EINTR)
+            ;
+
+        // Die the same way, so the shell reports the command's fate
+        if (WIFSIGNALED(status))
+        {
+            signal(WTERMSIG(status), SIG_DFL);
+            raise(WTERMSIG(status));
+        }
+        if (relayed != 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0)
+            _exit(1);
+        _exit(WIFEXITED(status) ? WEXITSTATUS(status) : 1);
+    }
+
+    if (pid == -1)
+    {
+        perror("fork failed");
+    }
+    else
+    {
+        stats_since(STAT_SPAWN, start);
+        // Set the group from both sides so later stages can join it at once
+        if (spec->pgid == LAUNCH_NEW_GROUP)
+            setpgid(pid, pid);
+        else if (spec->pgid != LAUNCH_SAME_GROUP)
+            setpgid(pid, spec->pgid);
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+    fanout_close(&targets);
+    if (in_fd != -1)
+        close(in_fd);
+    return pid;
+}
+
+// Start path through the fork server, or with posix_spawn without one
+static int spawn(pid_t *pid, const char *path, const launch_spec_t *spec, int in_fd, int out_fd,
+                 const posix_spawn_file_actions_t *actions, const posix_spawnattr_t *attr)
+{
+    int fds[3] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    if (spec->stdin_fd != -1)
+        fds[0] = spec->stdin_fd;
+    if (spec->stdout_fd != -1)
+        fds[1] = spec->stdout_fd;
+    if (in_fd != -1)
+        fds[0] = in_fd;
+    if (out_fd != -1)
+        fds[1] = out_fd;
+
+    int err = zygote_spawn(pid, path, spec->argv, fds, spec->keep_fds, spec->keep_count, spec->pgid);
+    if (err != ZYGOTE_UNAVAILABLE)
+        return err;
+    return posix_spawn(pid, path, actions, attr, spec->argv, environ);
+}
+
+pid_t launch_process(const launch_spec_t *spec)
+{
+    int in_fd = -1, out_fd = -1;
+    pid_t pid = -1;
+
+    if (spec->output_count > 1)
+    {
+        return launch_fanout(spec);
+    }
+
+    // Open redirections up front so failures are reported exactly as the
+    // shell always has, before anything is started
+    if (spec->input_file && (in_fd = launch_open_input(spec->input_file)) == -1)
+    {
+        return -1;
+    }
+    if (spec->output_file && (out_fd = launch_open_output(spec->output_file, spec->append_mode)) == -1)
+    {
+        if (in_fd != -1)
+            close(in_fd);
+        return -1;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_init(&attr);
+
+    // Later dup2s win, so explicit files override pipe ends
+    if (spec->stdin_fd != -1 && spec->stdin_fd != STDIN_FILENO)
+        posix_spawn_file_actions_adddup2(&actions, spec->stdin_fd, STDIN_FILENO);
+    if (spec->stdout_fd != -1 && spec->stdout_fd != STDOUT_FILENO)
+        posix_spawn_file_actions_adddup2(&actions, spec->stdout_fd, STDOUT_FILENO);
+    if (in_fd != -1)
+        posix_spawn_file_actions_adddup2(&actions, in_fd, STDIN_FILENO);
+    if (out_fd != -1)
+        posix_spawn_file_actions_adddup2(&actions, out_fd, STDOUT_FILENO);
+
+    // dup2 onto itself clears close-on-exec for just this child
+    for (int i = 0; i < spec->keep_count; i++)
+        posix_spawn_file_actions_adddup2(&actions, spec->keep_fds[i], spec->keep_fds[i]);
+
+    // The shell keeps SIGCHLD/SIGINT/SIGTSTP blocked for its signalfd, and
+    // a parallel runner ignores SIGTSTP; commands get neither
+    sigset_t empty, job_signals;
+    sigemptyset(&empty);
+    sigemptyset(&job_signals);
+    sigaddset(&job_signals, SIGINT);
+    sigaddset(&job_signals, SIGTSTP);
+    posix_spawnattr_setsigmask(&attr, &empty);
+    posix_spawnattr_setsigdefault(&attr, &job_signals);
+
+    short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+    if (spec->pgid != LAUNCH_SAME_GROUP)
+    {
+        posix_spawnattr_setpgroup(&attr, spec->pgid);
+        flags |= POSIX_SPAWN_SETPGROUP;
+    }
+    posix_spawnattr_setflags(&attr, flags);
+
+    // Shell output still buffered must come before the child's
+    fflush(stdout);
+
+    // PATH is walked once per command name; a cached binary that has since
+    // disappeared is looked up again
+    uint64_t start = stats_now();
+    const char *path = path_cache_lookup(spec->argv[0]);
+    int err = path ? spawn(&pid, path, spec, in_fd, out_fd, &actions, &attr) : ENOENT;
+    if (err == ENOENT && path && path != spec->argv[0])
+    {
+        path_cache_forget(spec->argv[0]);
+        path = path_cache_lookup(spec->argv[0]);
+        err = path ? spawn(&pid, path, spec, in_fd, out_fd, &actions, &attr) : ENOENT;
+    }
+    stats_since(STAT_SPAWN, start);
+    if (err != 0)
+    {
+        pid = -1;
+        if (err == ENOENT || err == EACCES || err == ENOEXEC || err == ENOTDIR)
+            printf("Command not found!\n");
+        else
+            fprintf(stderr, "spawn failed: %s\n", strerror(err));
+    }
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    if (in_fd != -1)
+        close(in_fd);
+    if (out_fd != -1)
+        close(out_fd);
+
+    return pid;
+}
+
+/* ############## LLM Generated Code Ends ################ */
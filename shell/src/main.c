@@ -5,18 +5,22 @@
 #include <limits.h>
 #include <errno.h>
 #include <signal.h>
+#include <fcntl.h>
 #include "shell.h"
 #include "prompt.h"
 #include "parser.h"
 #include "commands.h"
 #include "redirection.h"
+#include "parse_cache.h"
+#include "input.h"
+#include "events.h"
+#include "trace.h"
+#include "heredoc.h"
+#include "zygote.h"
 /* ############## LLM Generated Code Begins ############## */
 char g_shell_home[PATH_MAX];
 char g_shell_prev[PATH_MAX] = {0};
 
-background_job_t g_background_jobs[MAX_BACKGROUND_JOBS];
-int g_next_job_id = 1;
-
 char g_log_commands[MAX_LOG_COMMANDS][1024];
 int g_log_count = 0;
 int g_log_start = 0;
@@ -25,153 +29,168 @@ pid_t g_foreground_pid = 0;
 pid_t g_foreground_pgid = 0;
 char g_foreground_command[256] = {0};
 
-volatile sig_atomic_t sigint_received = 0;
-volatile sig_atomic_t sigtstp_received = 0;
-
 int g_hop_called = 0;
 
-int main(void)
+arena_t g_line_arena;
+
+int g_batch_mode = 0;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-s script]\n", prog);
+}
+
+int main(int argc, char **argv)
 {
+    int input_fd = STDIN_FILENO;
+
+    // -s script runs a file non-interactively; so does a non-tty stdin
+    if (argc == 3 && strcmp(argv[1], "-s") == 0)
+    {
+        input_fd = open(argv[2], O_RDONLY | O_CLOEXEC);
+        if (input_fd == -1)
+        {
+            fprintf(stderr, "%s: cannot open script '%s'\n", argv[0], argv[2]);
+            return 1;
+        }
+        g_batch_mode = 1;
+    }
+    else if (argc != 1)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    else if (!isatty(STDIN_FILENO))
+    {
+        g_batch_mode = 1;
+    }
+
     if (prompt_init() != 0)
     {
         fprintf(stderr, "Failed to initialize prompt\n");
         return 1;
     }
 
+    line_reader_t reader;
+    if (reader_init(&reader, input_fd, INPUT_BUFFER_SIZE) != 0)
+    {
+        perror("malloc failed");
+        return 1;
+    }
+
+    // Batch mode: fully buffered stdout (flushed before every launch and
+    // between batches) and no prompt
+    static char stdout_buf[INPUT_BUFFER_SIZE];
+    if (g_batch_mode)
+    {
+        setvbuf(stdout, stdout_buf, _IOFBF, sizeof stdout_buf);
+    }
+
     log_init();
+    arena_init(&g_line_arena);
     init_background_jobs();
-    setup_signal_handlers();
+    if (events_init(input_fd) != 0)
+    {
+        return 1;
+    }
+
+    // The fork server is forked now, while the shell is still small and
+    // with its signals set up (SIGTTOU ignored, as children inherit it)
+    zygote_start();
+    trace_init();
 
     for (;;)
     {
-        check_background_jobs();
+        if (!g_batch_mode)
+        {
+            // Job notifications that came in during the last command go
+            // before the prompt; later ones are printed as they happen
+            events_poll();
 
-        char p[SHELL_PROMPT_MAX];
-        if (prompt_build(p, sizeof p) == 0)
+            char p[SHELL_PROMPT_MAX];
+            if (prompt_build(p, sizeof p) == 0)
+            {
+                printf("%s", p);
+                fflush(stdout);
+            }
+            if (!reader_has_line(&reader) && events_wait_input())
+            {
+                printf("\n");
+                continue;
+            }
+        }
+        else if (!reader_has_line(&reader))
         {
-            printf("%s", p);
+            // End of a batch: the next line needs a read() anyway
             fflush(stdout);
+            while (events_wait_input())
+                ;
         }
 
-        char *line = NULL;
-        size_t cap = 0;
+        char *line;
+        ssize_t n = reader_next_line(&reader, &line);
 
-        ssize_t n = getline(&line, &cap, stdin);
-
-        if (n < 0)
+        if (n == -1)
         {
-            if (feof(stdin))
-            {
-                cleanup_and_exit();
-            }
-            else if (errno == EINTR)
+            cleanup_and_exit();
+        }
+        else if (n < 0)
+        {
+            if (errno == EINTR)
             {
                 printf("\n");
-                if (line)
-                    free(line);
-                clearerr(stdin);
-                fflush(stdin); // ADD THIS LINE
                 errno = 0;
                 continue;
             }
-            else
-            {
-                perror("getline");
-                if (line)
-                    free(line);
-                break;
-            }
+            perror("read");
+            break;
         }
 
-        if (n > 0 && line[n - 1] == '\n')
-        {
-            line[n - 1] = '\0';
-            n--;
+        // Trim leading and trailing whitespace
+        char *trimmed = line;
+        while (*trimmed == ' ' || *trimmed == '\t' || *trimmed == '\n' || *trimmed == '\r') {
+            trimmed++;
         }
 
-        check_background_jobs();
-if (strlen(line) > 0)
-{
-    // Trim leading and trailing whitespace
-    char *trimmed = line;
-    while (*trimmed == ' ' || *trimmed == '\t' || *trimmed == '\n' || *trimmed == '\r') {
-        trimmed++;
-    }
-    
-    // Find end and trim trailing whitespace
-    char *end = trimmed + strlen(trimmed) - 1;
-    while (end > trimmed && (*end == ' ' || *end == '\t' || *end == '\n' || *end == '\r')) {
-        *end = '\0';
-        end--;
-    }
-    
-    // Skip empty input after trimming
-    if (strlen(trimmed) == 0) {
-        free(line);
-        continue;
-    }
-    
-    // Use trimmed input for all processing
-    if (parse_command(trimmed) != 0)
-    {
-        printf("Invalid Syntax!\n");
-        log_add_command(trimmed);  // Use trimmed, not line
-    }
-    else
-    {
-        if (!log_contains_log_command(trimmed))
-        {
-            log_add_command(trimmed);  // Use trimmed, not line
+        // Find end and trim trailing whitespace
+        char *end = trimmed + strlen(trimmed) - 1;
+        while (end > trimmed && (*end == ' ' || *end == '\t' || *end == '\n' || *end == '\r')) {
+            *end = '\0';
+            end--;
         }
 
-        // Check for sequential commands first (contains semicolon)
-        if (strchr(trimmed, ';') != NULL)
-        {
-            sequential_commands_t seq_cmds;
-            if (parse_sequential_commands(trimmed, &seq_cmds) == 0)
-            {
-                execute_sequential_commands(&seq_cmds);
-                cleanup_sequential_commands(&seq_cmds);
-            }
-            else
-            {
-                printf("Invalid Syntax!\n");
-            }
+        // Skip empty input after trimming
+        if (strlen(trimmed) == 0) {
+            continue;
         }
-        // ... rest of your logic using 'trimmed' instead of 'line'
-        else if (strchr(trimmed, '|') != NULL || strchr(trimmed, '&') != NULL)
+
+        // One pass over the line both validates it and builds the command tree;
+        // a line seen recently comes straight from the parse cache
+        sequential_commands_t *seq_cmds = parse_cache_acquire(trimmed);
+        if (!seq_cmds)
         {
-            command_pipeline_t pipeline;
-            if (parse_pipeline(trimmed, &pipeline) == 0)
-            {
-                execute_pipeline(&pipeline);
-                cleanup_pipeline(&pipeline);
-            }
-            else
-            {
-                printf("Invalid Syntax!\n");
-            }
+            printf("Invalid Syntax!\n");
+            log_add_command(trimmed);  // Use trimmed, not line
         }
-        else if (strchr(trimmed, '<') != NULL || strchr(trimmed, '>') != NULL)
+        else
         {
-            parsed_command_t cmd;
-            if (parse_command_with_redirection(trimmed, &cmd) == 0)
+            if (!log_contains_log_command(trimmed))
             {
-                execute_command_with_redirection(&cmd);
-                cleanup_parsed_command(&cmd);
+                log_add_command(trimmed);  // Use trimmed, not line
             }
-            else
+
+            // Here-document bodies are the next lines of input (this
+            // moves the reader on, so trimmed is not used past this point);
+            // Ctrl-C while one is being typed drops the whole line
+            if (heredoc_collect(seq_cmds, &reader) != HEREDOC_INTERRUPTED)
             {
-                execute_command(trimmed);
+                execute_sequential_commands(seq_cmds);
             }
+            parse_cache_release(seq_cmds);
         }
-        else
-        {
-            execute_command(trimmed);
-        }
-    }
-}
-        free(line);
+
+        // Everything parsed or allocated for this line goes at once
+        arena_reset(&g_line_arena);
     }
     return 0;
 }
@@ -0,0 +1,499 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "shell.h"
+#include "memo.h"
+#include "launch.h"
+#include "heredoc.h"
+#include "pathcache.h"
+#include "events.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+extern char **environ;
+
+#define MEMO_MAGIC "shmemo2"
+
+// Largest chunk the relay reads and logs at once
+#define MEMO_CHUNK_MAX 65536
+
+#define MEMO_STREAM_OUT 1
+#define MEMO_STREAM_ERR 2
+
+// An entry: this header, the key, then log_len bytes of chunks
+typedef struct
+{
+    char magic[8];
+    int32_t status;
+    uint32_t unused;
+    uint64_t key_len;
+    uint64_t log_len;
+} memo_header_t;
+
+// One write of the command's, as the relay read it: this, then len bytes
+typedef struct
+{
+    uint32_t stream;    // MEMO_STREAM_OUT or MEMO_STREAM_ERR
+    uint32_t len;
+} memo_chunk_t;
+
+static int append(memo_key_t *key, const void *data, size_t len)
+{
+    if (key->len + len > key->cap)
+    {
+        size_t cap = key->cap ? key->cap * 2 : 1024;
+        while (cap < key->len + len)
+            cap *= 2;
+        char *grown = arena_realloc(&g_line_arena, key->data, key->cap, cap);
+        if (!grown)
+        {
+            perror("malloc failed");
+            return -1;
+        }
+        key->data = grown;
+        key->cap = cap;
+    }
+    memcpy(key->data + key->len, data, len);
+    key->len += len;
+    return 0;
+}
+
+// Strings go in with their NUL, so consecutive ones cannot run together
+static int append_string(memo_key_t *key, const char *s)
+{
+    return append(key, s, strlen(s) + 1);
+}
+
+// tag, path and what identifies the file there now (nothing if missing)
+static int append_file(memo_key_t *key, const char *tag, const char *path)
+{
+    char id[128] = "";
+    struct stat st;
+    if (stat(path, &st) == 0)
+        snprintf(id, sizeof id, "%llu %llu %lld %lld.%09ld", (unsigned long long)st.st_dev,
+                 (unsigned long long)st.st_ino, (long long)st.st_size,
+                 (long long)st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+
+    if (append_string(key, tag) != 0 || append_string(key, path) != 0)
+        return -1;
+    return append_string(key, id);
+}
+
+static int append_here_body(memo_key_t *key, const parsed_command_t *cmd)
+{
+    int fd = heredoc_open(cmd);
+    if (fd == -1)
+        return -1;
+
+    int result = append_string(key, "here");
+    char buf[4096];
+    ssize_t n;
+    while (result == 0 && (n = read(fd, buf, sizeof buf)) > 0)
+        result = append(key, buf, n);
+    close(fd);
+    return result;
+}
+
+// FNV-1a over the key
+static uint64_t hash_key(const char *data, size_t len)
+{
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+int memo_key(const parsed_command_t *cmd, memo_key_t *key)
+{
+    key->data = NULL;
+    key->len = key->cap = 0;
+
+    // The output of a substituted pipeline is not known before it runs
+    if (cmd->proc_sub_count > 0)
+        return -1;
+
+    char cwd[PATH_MAX], count[16];
+    if (!getcwd(cwd, sizeof cwd))
+        return -1;
+
+    snprintf(count, sizeof count, "%d", cmd->arg_count + 1);
+    if (append_string(key, "argv") != 0 || append_string(key, count) != 0 ||
+        append_string(key, cmd->command) != 0)
+        return -1;
+    for (int i = 0; i < cmd->arg_count; i++)
+        if (append_string(key, cmd->args[i]) != 0)
+            return -1;
+
+    if (append_string(key, "cwd") != 0 || append_string(key, cwd) != 0 ||
+        append_string(key, "env") != 0)
+        return -1;
+    for (char **e = environ; *e; e++)
+        if (append_string(key, *e) != 0)
+            return -1;
+
+    // A builtin has no binary; its name is all there is
+    const char *path = path_cache_lookup(cmd->command);
+    if (path && append_file(key, "bin", path) != 0)
+        return -1;
+    if (cmd->input_file && append_file(key, "in", cmd->input_file) != 0)
+        return -1;
+    for (int i = 0; i < cmd->arg_count; i++)
+    {
+        struct stat st;
+        if (stat(cmd->args[i], &st) == 0 && append_file(key, "arg", cmd->args[i]) != 0)
+            return -1;
+    }
+    if ((cmd->here_doc || cmd->here_string) && append_here_body(key, cmd) != 0)
+        return -1;
+
+    key->hash = hash_key(key->data, key->len);
+    snprintf(key->path, sizeof key->path, "%s/%s/%016llx", g_shell_home, MEMO_DIRNAME,
+             (unsigned long long)key->hash);
+    return 0;
+}
+
+static int write_all(int fd, const void *buf, size_t len)
+{
+    for (size_t done = 0; done < len;)
+    {
+        ssize_t w = write(fd, (const char *)buf + done, len - done);
+        if (w == -1 && errno == EINTR)
+            continue;
+        if (w <= 0)
+            return -1;
+        done += w;
+    }
+    return 0;
+}
+
+// Copy len bytes at offset off of in into out; 0 once all are written
+static int copy_range(int out, int in, off_t off, size_t len)
+{
+    off_t end = off + len;
+    while (off < end)
+    {
+        ssize_t n = sendfile(out, in, &off, end - off);
+        if (n > 0)
+            continue;
+        if (n == -1 && errno == EINTR)
+            continue;
+        break;
+    }
+
+    // sendfile refuses some outputs (an O_APPEND file); copy by hand
+    char buf[8192];
+    while (off < end)
+    {
+        size_t want = end - off < (off_t)sizeof buf ? (size_t)(end - off) : sizeof buf;
+        ssize_t n = pread(in, buf, want, off);
+        if (n <= 0 || write_all(out, buf, n) != 0)
+            return -1;
+        off += n;
+    }
+    return 0;
+}
+
+// Open every file cmd's stdout is redirected to, into targets (at least
+// one slot per output); *count is 0 if stdout is not redirected.  -1 after
+// the shell's error if one cannot be opened, with none left open.
+static int open_targets(const parsed_command_t *cmd, int *targets, int *count)
+{
+    *count = 0;
+    if (cmd->output_count <= 1 && !cmd->output_file)
+        return 0;
+
+    int total = cmd->output_count > 1 ? cmd->output_count : 1;
+    for (int i = 0; i < total; i++)
+    {
+        const char *file = cmd->output_count > 1 ? cmd->outputs[i] : cmd->output_file;
+        int append_mode = cmd->output_count > 1 ? cmd->output_appends[i] : cmd->append_mode;
+        int fd = launch_open_output(file, append_mode);
+        if (fd == -1)
+        {
+            while (*count > 0)
+                close(targets[--*count]);
+            return -1;
+        }
+        targets[(*count)++] = fd;
+    }
+    return 0;
+}
+
+// Write one chunk of the command's output where it goes: stdout to every
+// target (the shell's stdout if there are none), stderr to the shell's
+static void deliver(int stream, const char *buf, size_t len, const int *targets, int count)
+{
+    if (stream == MEMO_STREAM_ERR)
+    {
+        write_all(STDERR_FILENO, buf, len);
+        return;
+    }
+    if (count == 0)
+        write_all(STDOUT_FILENO, buf, len);
+    for (int i = 0; i < count; i++)
+        write_all(targets[i], buf, len);
+}
+
+// Whether the key stored at offset off of fd is key
+static int key_matches(int fd, off_t off, const memo_key_t *key)
+{
+    char buf[4096];
+    for (size_t done = 0; done < key->len;)
+    {
+        size_t want = key->len - done < sizeof buf ? key->len - done : sizeof buf;
+        if (pread(fd, buf, want, off + done) != (ssize_t)want ||
+            memcmp(buf, key->data + done, want) != 0)
+            return 0;
+        done += want;
+    }
+    return 1;
+}
+
+int memo_replay(const memo_key_t *key, const parsed_command_t *cmd, int *status)
+{
+    int fd = open(key->path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return 0;
+
+    memo_header_t h;
+    int hit = pread(fd, &h, sizeof h, 0) == sizeof h &&
+              memcmp(h.magic, MEMO_MAGIC, sizeof h.magic) == 0 &&
+              h.key_len == key->len && key_matches(fd, sizeof h, key);
+    int targets_buf[1];
+    int *targets = cmd->output_count > 1 ? arena_alloc(&g_line_arena, cmd->output_count * sizeof(int))
+                                         : targets_buf;
+    int count;
+    if (!hit || !targets)
+    {
+        close(fd);
+        return 0;
+    }
+
+    // A target that cannot be opened fails the command, as it would run
+    if (open_targets(cmd, targets, &count) != 0)
+    {
+        close(fd);
+        *status = 1;
+        return 1;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+
+    // The chunks in the order the command wrote them
+    off_t off = sizeof h + h.key_len, end = off + h.log_len;
+    while (off < end)
+    {
+        memo_chunk_t c;
+        if (pread(fd, &c, sizeof c, off) != sizeof c)
+            break;
+        off += sizeof c;
+        if (c.stream == MEMO_STREAM_ERR)
+            copy_range(STDERR_FILENO, fd, off, c.len);
+        else if (count == 0)
+            copy_range(STDOUT_FILENO, fd, off, c.len);
+        for (int i = 0; c.stream == MEMO_STREAM_OUT && i < count; i++)
+            copy_range(targets[i], fd, off, c.len);
+        off += c.len;
+    }
+
+    for (int i = 0; i < count; i++)
+        close(targets[i]);
+    close(fd);
+    *status = h.status;
+    return 1;
+}
+
+// The relay: copy whatever arrives on the two pipes to where it goes and
+// append it to the log as chunks, until the command's side is closed
+static void relay(int out_fd, int err_fd, const int *targets, int count, int log_fd)
+{
+    static char buf[MEMO_CHUNK_MAX];
+    struct pollfd pfds[2] = {{out_fd, POLLIN, 0}, {err_fd, POLLIN, 0}};
+    int streams[2] = {MEMO_STREAM_OUT, MEMO_STREAM_ERR};
+    int open_count = 2;
+
+    while (open_count > 0)
+    {
+        if (poll(pfds, 2, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            _exit(1);
+        }
+
+        for (int i = 0; i < 2; i++)
+        {
+            if (pfds[i].fd == -1 || !pfds[i].revents)
+                continue;
+            ssize_t n = read(pfds[i].fd, buf, sizeof buf);
+            if (n == -1 && errno == EINTR)
+                continue;
+            if (n <= 0)
+            {
+                close(pfds[i].fd);
+                pfds[i].fd = -1;
+                open_count--;
+                continue;
+            }
+
+            memo_chunk_t c = {streams[i], n};
+            deliver(streams[i], buf, n, targets, count);
+            if (write_all(log_fd, &c, sizeof c) != 0 || write_all(log_fd, buf, n) != 0)
+                _exit(1);
+        }
+    }
+    _exit(0);
+}
+
+int memo_capture_start(const parsed_command_t *cmd, memo_capture_t *cap)
+{
+    int targets_buf[1];
+    int *targets = cmd->output_count > 1 ? arena_alloc(&g_line_arena, cmd->output_count * sizeof(int))
+                                         : targets_buf;
+    int count, out[2], err[2];
+    if (!targets)
+    {
+        perror("malloc failed");
+        return -1;
+    }
+    if (open_targets(cmd, targets, &count) != 0)
+        return -1;
+
+    cap->log_fd = memfd_create("memo", MFD_CLOEXEC);
+    if (cap->log_fd == -1 || pipe2(out, O_CLOEXEC) == -1)
+    {
+        perror("memo");
+        if (cap->log_fd != -1)
+            close(cap->log_fd);
+        for (int i = 0; i < count; i++)
+            close(targets[i]);
+        return -1;
+    }
+    if (pipe2(err, O_CLOEXEC) == -1)
+    {
+        perror("memo");
+        close(out[0]);
+        close(out[1]);
+        close(cap->log_fd);
+        for (int i = 0; i < count; i++)
+            close(targets[i]);
+        return -1;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+
+    cap->relay = fork();
+    if (cap->relay == 0)
+    {
+        // The relay may outlive the line (a stopped command), so it keeps
+        // none of the shell's descriptors; without the write ends it sees
+        // EOF once the command's copies are all closed
+        int *keep = malloc((count + 3) * sizeof *keep);
+        if (keep)
+        {
+            int nkeep = 0;
+            keep[nkeep++] = out[0];
+            keep[nkeep++] = err[0];
+            keep[nkeep++] = cap->log_fd;
+            for (int i = 0; i < count; i++)
+                keep[nkeep++] = targets[i];
+            launch_close_others(keep, nkeep);
+            free(keep);
+        }
+        else
+        {
+            close(out[1]);
+            close(err[1]);
+        }
+        relay(out[0], err[0], targets, count, cap->log_fd);
+    }
+
+    close(out[0]);
+    close(err[0]);
+    for (int i = 0; i < count; i++)
+        close(targets[i]);
+    if (cap->relay == -1)
+    {
+        perror("fork failed");
+        close(out[1]);
+        close(err[1]);
+        close(cap->log_fd);
+        return -1;
+    }
+    cap->out_fd = out[1];
+    cap->err_fd = err[1];
+    return 0;
+}
+
+// Write the entry under a temporary name and rename it into place, so a
+// concurrent lookup sees the old entry or the whole new one
+static void store(const memo_key_t *key, int log_fd, size_t log_len, int status)
+{
+    char dir[PATH_MAX + 16], tmp[PATH_MAX + 96];
+    snprintf(dir, sizeof dir, "%s/%s", g_shell_home, MEMO_DIRNAME);
+    if (mkdir(dir, 0700) == -1 && errno != EEXIST)
+    {
+        perror("memo");
+        return;
+    }
+
+    snprintf(tmp, sizeof tmp, "%s.%d.tmp", key->path, (int)getpid());
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd == -1)
+    {
+        perror("memo");
+        return;
+    }
+
+    memo_header_t h = {MEMO_MAGIC, status, 0, key->len, log_len};
+    int ok = write_all(fd, &h, sizeof h) == 0 &&
+             write_all(fd, key->data, key->len) == 0 &&
+             copy_range(fd, log_fd, 0, log_len) == 0;
+    close(fd);
+    if (!ok || rename(tmp, key->path) == -1)
+    {
+        perror("memo");
+        unlink(tmp);
+    }
+}
+
+void memo_capture_finish(memo_capture_t *cap, const memo_key_t *key, int status, int keep)
+{
+    close(cap->out_fd);
+    close(cap->err_fd);
+
+    if (!keep)
+    {
+        // A stopped command may write more when continued; the relay
+        // goes on forwarding it and is reaped by the event loop
+        events_watch_quiet(cap->relay, 0);
+        close(cap->log_fd);
+        return;
+    }
+
+    int relay_status;
+    while (waitpid(cap->relay, &relay_status, 0) == -1 && errno == EINTR)
+        ;
+
+    // A relay that failed (its output gone, say) has an incomplete log
+    struct stat st;
+    if (relay_status == 0 && fstat(cap->log_fd, &st) == 0)
+        store(key, cap->log_fd, st.st_size, status);
+    close(cap->log_fd);
+}
+
+/* ############## LLM Generated Code Ends ################ */
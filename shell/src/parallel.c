@@ -0,0 +1,579 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "shell.h"
+#include "parallel.h"
+#include "events.h"
+#include "input.h"
+#include "launch.h"
+#include "parse_cache.h"
+#include "redirection.h"
+#include "trace.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+typedef struct
+{
+    int task;       // Input line number, counted from 0
+    int out_fd;     // Captured output (ordered mode), else -1
+    int err_fd;     // Captured stderr, replayed to stderr, else -1
+    int done;
+} parallel_task_t;
+
+typedef struct
+{
+    parallel_task_t *tasks;
+    int count;
+    int cap;
+    int emitted;    // Tasks already written out, in input order
+} task_list_t;
+
+// par's input, cut into blocks that end on a line boundary
+typedef struct
+{
+    int fd;
+    char *buf;
+    size_t cap;
+    size_t len;     // Bytes read; what follows the block is kept
+    int at_eof;
+} block_reader_t;
+
+static void usage(void)
+{
+    printf("parallel: usage: parallel [-j N] [-u] [file]\n");
+}
+
+static int parse_jobs(const char *who, const char *arg)
+{
+    char *end;
+    long n = strtol(arg, &end, 10);
+    if (*arg == '\0' || *end != '\0' || n < 1 || n > 4096)
+    {
+        printf("%s: %s: invalid job count\n", who, arg);
+        return -1;
+    }
+    return (int)n;
+}
+
+// Append a task numbered after the last, its stdout captured when ordered
+// and its stderr too when with_err; NULL if out of memory
+static parallel_task_t *add_task(task_list_t *list, int ordered, int with_err)
+{
+    if (list->count == list->cap)
+    {
+        int cap = list->cap ? list->cap * 2 : 16;
+        parallel_task_t *tasks = realloc(list->tasks, cap * sizeof *tasks);
+        if (!tasks)
+        {
+            perror("malloc failed");
+            return NULL;
+        }
+        list->tasks = tasks;
+        list->cap = cap;
+    }
+
+    parallel_task_t *t = &list->tasks[list->count];
+    t->task = list->count;
+    t->done = 0;
+    t->out_fd = -1;
+    t->err_fd = -1;
+    if (ordered && (t->out_fd = memfd_create("parallel", MFD_CLOEXEC)) == -1)
+    {
+        perror("memfd_create");
+        return NULL;
+    }
+    if (ordered && with_err &&
+        (t->err_fd = memfd_create("parallel-err", MFD_CLOEXEC)) == -1)
+    {
+        perror("memfd_create");
+        close(t->out_fd);
+        return NULL;
+    }
+    return t;
+}
+
+// Next non-blank command line, or NULL at end of input
+static char *next_line(line_reader_t *reader)
+{
+    while (1)
+    {
+        char *line;
+        ssize_t len = reader_next_line(reader, &line);
+        if (len == -2 && errno == EINTR)
+            continue;
+        if (len < 0)
+            return NULL;
+
+        while (*line == ' ' || *line == '\t')
+            line++;
+        if (*line != '\0')
+            return line;
+    }
+}
+
+// Write everything captured in fd to out (stdout or stderr)
+static void copy_output(int fd, int out)
+{
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0)
+        return;
+
+    // The shell's own buffers go first so the bytes stay in order
+    fflush(stdout);
+    fflush(stderr);
+
+    off_t offset = 0;
+    while (offset < st.st_size)
+    {
+        ssize_t n = sendfile(out, fd, &offset, st.st_size - offset);
+        if (n > 0)
+            continue;
+        if (n == -1 && errno == EINTR)
+            continue;
+        break;
+    }
+
+    // sendfile refuses some outputs (an O_APPEND file); copy by hand
+    char buf[8192];
+    while (offset < st.st_size)
+    {
+        ssize_t n = pread(fd, buf, sizeof buf, offset);
+        if (n <= 0)
+            break;
+        if (write(out, buf, n) != n)
+            break;
+        offset += n;
+    }
+}
+
+// Drop a task's captures, written out or not
+static void close_task(parallel_task_t *t)
+{
+    if (t->out_fd != -1)
+        close(t->out_fd);
+    if (t->err_fd != -1)
+        close(t->err_fd);
+    t->out_fd = t->err_fd = -1;
+}
+
+// Write out every finished task at the front of the input order: its
+// stdout to stdout, then its stderr to stderr
+static void emit_ready(task_list_t *list)
+{
+    while (list->emitted < list->count && list->tasks[list->emitted].done)
+    {
+        parallel_task_t *t = &list->tasks[list->emitted++];
+        if (t->out_fd != -1)
+            copy_output(t->out_fd, STDOUT_FILENO);
+        if (t->err_fd != -1)
+            copy_output(t->err_fd, STDERR_FILENO);
+        close_task(t);
+    }
+}
+
+// Fork a copy of the shell that runs one command line
+static pid_t start_runner(const char *line, int out_fd, int err_fd)
+{
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid > 0)
+        trace_launch(pid, getpgrp(), line);
+    if (pid != 0)
+        return pid;
+
+    int null_fd = open("/dev/null", O_RDONLY);
+    if (null_fd != -1)
+        dup2(null_fd, STDIN_FILENO);
+    if (out_fd != -1)
+        dup2(out_fd, STDOUT_FILENO);
+    if (err_fd != -1)
+        dup2(err_fd, STDERR_FILENO);
+
+    // Not the interactive shell any more: no prompts or job notifications,
+    // and none of the parent's descriptors.  Ctrl-Z is for the terminal's
+    // foreground commands; a runner is not one and must not stop.
+    g_batch_mode = 1;
+    events_reset_child(STDIN_FILENO);
+    trace_close_fds(3);
+    signal(SIGTSTP, SIG_IGN);
+
+    int status = -1;
+    sequential_commands_t *seq_cmds = parse_cache_acquire(line);
+    if (!seq_cmds)
+        printf("Invalid Syntax!\n");
+    else
+        status = execute_sequential_commands(seq_cmds);
+
+    fflush(stdout);
+    fflush(stderr);
+    _exit(status == 0 ? 0 : 1);
+}
+
+int execute_parallel(int argc, char **argv)
+{
+    int jobs = PARALLEL_DEFAULT_JOBS;
+    int ordered = 1;
+    const char *file = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-u") == 0)
+        {
+            ordered = 0;
+        }
+        else if (strncmp(argv[i], "-j", 2) == 0)
+        {
+            const char *arg = argv[i][2] ? argv[i] + 2 : argv[++i];
+            if (!arg)
+            {
+                usage();
+                return -1;
+            }
+            if ((jobs = parse_jobs("parallel", arg)) == -1)
+                return -1;
+        }
+        else if (argv[i][0] == '-' || file)
+        {
+            usage();
+            return -1;
+        }
+        else
+        {
+            file = argv[i];
+        }
+    }
+
+    if (jobs == PARALLEL_DEFAULT_JOBS)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        jobs = cpus > 0 ? (int)cpus : 1;
+    }
+
+    int in_fd = STDIN_FILENO;
+    if (file && (in_fd = open(file, O_RDONLY | O_CLOEXEC)) == -1)
+    {
+        printf("parallel: %s: %s\n", file, strerror(errno));
+        return -1;
+    }
+
+    line_reader_t reader;
+    pid_t *pids = malloc(jobs * sizeof *pids);
+    int *statuses = malloc(jobs * sizeof *statuses);
+    int *slot_task = malloc(jobs * sizeof *slot_task);
+    task_list_t list = {0};
+    if (!pids || !statuses || !slot_task || reader_init(&reader, in_fd, INPUT_BUFFER_SIZE) != 0)
+    {
+        perror("malloc failed");
+        free(pids);
+        free(statuses);
+        free(slot_task);
+        if (file)
+            close(in_fd);
+        return -1;
+    }
+    for (int i = 0; i < jobs; i++)
+        pids[i] = 0;
+
+    int running = 0, at_eof = 0, interrupted = 0, failed = 0;
+    while (1)
+    {
+        // Fill every free slot with the next line
+        for (int slot = 0; slot < jobs && !at_eof && !interrupted; slot++)
+        {
+            if (pids[slot] > 0)
+                continue;
+
+            char *line = next_line(&reader);
+            if (!line)
+            {
+                at_eof = 1;
+                break;
+            }
+
+            parallel_task_t *t = add_task(&list, ordered, 1);
+            if (!t)
+            {
+                at_eof = 1;
+                break;
+            }
+
+            pid_t pid = start_runner(line, t->out_fd, t->err_fd);
+            if (pid == -1)
+            {
+                perror("fork failed");
+                close_task(t);
+                at_eof = 1;
+                break;
+            }
+            list.count++;
+            pids[slot] = pid;
+            statuses[slot] = -1;
+            slot_task[slot] = t->task;
+            running++;
+        }
+
+        if (running == 0)
+            break;
+
+        // Ctrl-C has already reached the runners (they share the shell's
+        // process group); only stop starting new lines
+        if (events_wait_any(pids, statuses, jobs))
+            interrupted = 1;
+
+        for (int slot = 0; slot < jobs; slot++)
+        {
+            if (pids[slot] <= 0 || statuses[slot] == -1)
+                continue;
+
+            parallel_task_t *t = &list.tasks[slot_task[slot]];
+            t->done = 1;
+            if (!WIFEXITED(statuses[slot]) || WEXITSTATUS(statuses[slot]) != 0)
+                failed = 1;
+            pids[slot] = 0;
+            running--;
+        }
+
+        if (ordered)
+            emit_ready(&list);
+    }
+
+    // Whatever is left is behind a line that never ran
+    for (int i = list.emitted; i < list.count; i++)
+        close_task(&list.tasks[i]);
+
+    reader_destroy(&reader);
+    if (file)
+        close(in_fd);
+    free(list.tasks);
+    free(pids);
+    free(statuses);
+    free(slot_task);
+    return failed || interrupted ? -1 : 0;
+}
+
+// Whether fd stays without input for PAR_IDLE_MS
+static int input_idle(int fd)
+{
+    struct pollfd p = {.fd = fd, .events = POLLIN};
+    return poll(&p, 1, PAR_IDLE_MS) == 0;
+}
+
+// Move the next block into a memfd, rewound for a copy to read.  Returns
+// the memfd, -1 at end of input or -2 after an error.
+static int next_block(block_reader_t *r)
+{
+    // End of the last whole line seen so far
+    size_t cut = 0;
+    char *nl = r->len ? memrchr(r->buf, '\n', r->len) : NULL;
+    if (nl)
+        cut = nl - r->buf + 1;
+
+    while (!r->at_eof && (cut == 0 || (r->len < PAR_BLOCK_SIZE && !input_idle(r->fd))))
+    {
+        // A line longer than a block makes the block longer
+        if (r->len == r->cap)
+        {
+            char *buf = realloc(r->buf, r->cap * 2);
+            if (!buf)
+            {
+                perror("malloc failed");
+                return -2;
+            }
+            r->buf = buf;
+            r->cap *= 2;
+        }
+
+        ssize_t n = read(r->fd, r->buf + r->len, r->cap - r->len);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1)
+        {
+            printf("par: %s\n", strerror(errno));
+            return -2;
+        }
+        if (n == 0)
+            r->at_eof = 1;
+        nl = memrchr(r->buf + r->len, '\n', n);
+        if (nl)
+            cut = nl - r->buf + 1;
+        r->len += n;
+    }
+
+    // The last line may lack its newline
+    if (r->at_eof)
+        cut = r->len;
+    if (cut == 0)
+        return -1;
+
+    int fd = memfd_create("par", MFD_CLOEXEC);
+    if (fd == -1)
+    {
+        perror("memfd_create");
+        return -2;
+    }
+    for (size_t off = 0; off < cut;)
+    {
+        ssize_t n = write(fd, r->buf + off, cut - off);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            perror("par: write");
+            close(fd);
+            return -2;
+        }
+        off += n;
+    }
+    lseek(fd, 0, SEEK_SET);
+
+    memmove(r->buf, r->buf + cut, r->len - cut);
+    r->len -= cut;
+    return fd;
+}
+
+// Spawn a copy of the stage's command on one block, its output captured
+// in out_fd.  It stays in the caller's group: the pipeline's, or the
+// shell's when par runs in it.
+static pid_t start_copy(char **argv, int in_fd, int out_fd)
+{
+    launch_spec_t spec = {
+        .argv = argv,
+        .stdin_fd = in_fd,
+        .stdout_fd = out_fd,
+        .pgid = LAUNCH_SAME_GROUP,
+    };
+
+    pid_t pid = launch_process(&spec);
+    if (pid > 0)
+        trace_launch(pid, getpgrp(), argv[0]);
+    return pid;
+}
+
+int execute_par(int argc, char **argv)
+{
+    int ordered = 1;
+    int first = 1;
+    if (first < argc && strcmp(argv[first], "-u") == 0)
+    {
+        ordered = 0;
+        first++;
+    }
+    if (argc - first < 2)
+    {
+        printf("par: usage: par [-u] N cmd [args]\n");
+        return -1;
+    }
+
+    int jobs = parse_jobs("par", argv[first]);
+    if (jobs == -1)
+        return -1;
+    char **cmd = argv + first + 1;
+
+    block_reader_t reader = {.fd = STDIN_FILENO, .cap = PAR_BLOCK_SIZE};
+    reader.buf = malloc(reader.cap);
+    pid_t *pids = malloc(jobs * sizeof *pids);
+    int *statuses = malloc(jobs * sizeof *statuses);
+    int *slot_task = malloc(jobs * sizeof *slot_task);
+    task_list_t list = {0};
+    if (!reader.buf || !pids || !statuses || !slot_task)
+    {
+        perror("malloc failed");
+        free(reader.buf);
+        free(pids);
+        free(statuses);
+        free(slot_task);
+        return -1;
+    }
+    for (int i = 0; i < jobs; i++)
+        pids[i] = 0;
+
+    int running = 0, at_eof = 0, interrupted = 0, failed = 0;
+    while (1)
+    {
+        // Hand the next block to every free slot
+        for (int slot = 0; slot < jobs && !at_eof && !interrupted; slot++)
+        {
+            if (pids[slot] > 0)
+                continue;
+
+            int block_fd = next_block(&reader);
+            if (block_fd < 0)
+            {
+                failed |= block_fd == -2;
+                at_eof = 1;
+                break;
+            }
+
+            parallel_task_t *t = add_task(&list, 1, 0);
+            pid_t pid = t ? start_copy(cmd, block_fd, t->out_fd) : -1;
+            close(block_fd);
+            if (pid == -1)
+            {
+                if (t)
+                    close_task(t);
+                failed = at_eof = 1;
+                break;
+            }
+            list.count++;
+            pids[slot] = pid;
+            statuses[slot] = -1;
+            slot_task[slot] = t->task;
+            running++;
+        }
+
+        if (running == 0)
+            break;
+
+        // Ctrl-C has already reached the copies (they share the group);
+        // only stop reading
+        if (events_wait_any(pids, statuses, jobs))
+            interrupted = 1;
+
+        for (int slot = 0; slot < jobs; slot++)
+        {
+            if (pids[slot] <= 0 || statuses[slot] == -1)
+                continue;
+
+            // Unordered output goes out at once; emit_ready then only
+            // steps over the task
+            parallel_task_t *t = &list.tasks[slot_task[slot]];
+            t->done = 1;
+            if (!ordered)
+            {
+                copy_output(t->out_fd, STDOUT_FILENO);
+                close_task(t);
+            }
+            if (!WIFEXITED(statuses[slot]) || WEXITSTATUS(statuses[slot]) != 0)
+                failed = 1;
+            pids[slot] = 0;
+            running--;
+        }
+
+        emit_ready(&list);
+    }
+
+    // Whatever is left is behind a block that never finished
+    for (int i = list.emitted; i < list.count; i++)
+        close_task(&list.tasks[i]);
+
+    free(reader.buf);
+    free(list.tasks);
+    free(pids);
+    free(statuses);
+    free(slot_task);
+    return failed || interrupted ? -1 : 0;
+}
+
+/* ############## LLM Generated Code Ends ################ */
@@ -0,0 +1,160 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "shell.h"
+#include "parse_cache.h"
+#include "stats.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+typedef struct
+{
+    int valid;
+    int pins;                   // Executions currently using the tree
+    uint64_t hash;
+    unsigned long last_used;    // LRU stamp within the set
+    char *line;                 // Exact text, to rule out hash collisions
+    sequential_commands_t seq;  // Parsed tree; all memory lives in arena
+    arena_t arena;
+} parse_cache_entry_t;
+
+static parse_cache_entry_t s_entries[PARSE_CACHE_SETS][PARSE_CACHE_WAYS];
+static unsigned long s_clock = 0;
+static unsigned long s_hits = 0;
+static unsigned long s_misses = 0;
+
+// FNV-1a over the line text
+static uint64_t hash_line(const char *line)
+{
+    uint64_t h = 1469598103934665603ULL;
+    while (*line)
+    {
+        h ^= (unsigned char)*line++;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static parse_cache_entry_t *entry_of(sequential_commands_t *seq_cmds)
+{
+    parse_cache_entry_t *first = &s_entries[0][0];
+    parse_cache_entry_t *last = &s_entries[PARSE_CACHE_SETS - 1][PARSE_CACHE_WAYS - 1];
+
+    for (parse_cache_entry_t *e = first; e <= last; e++)
+    {
+        if (&e->seq == seq_cmds)
+            return e;
+    }
+    return NULL;
+}
+
+static sequential_commands_t *lookup_or_parse(const char *line)
+{
+    uint64_t hash = hash_line(line);
+    parse_cache_entry_t *set = s_entries[hash % PARSE_CACHE_SETS];
+    parse_cache_entry_t *victim = NULL;
+
+    for (int i = 0; i < PARSE_CACHE_WAYS; i++)
+    {
+        parse_cache_entry_t *e = &set[i];
+        if (e->valid && e->hash == hash && strcmp(e->line, line) == 0)
+        {
+            s_hits++;
+            e->last_used = ++s_clock;
+            e->pins++;
+            return &e->seq;
+        }
+
+        // Prefer an empty way, otherwise the least recently used unpinned one
+        if (e->pins > 0)
+            continue;
+        if (!e->valid)
+        {
+            if (!victim || victim->valid)
+                victim = e;
+        }
+        else if (!victim || (victim->valid && e->last_used < victim->last_used))
+        {
+            victim = e;
+        }
+    }
+
+    s_misses++;
+
+    // Every way is busy executing: parse into the line arena, uncached
+    if (!victim)
+    {
+        sequential_commands_t *seq_cmds = arena_alloc(&g_line_arena, sizeof(*seq_cmds));
+        if (!seq_cmds || parse_sequential_commands(line, seq_cmds, &g_line_arena) != 0)
+            return NULL;
+        return seq_cmds;
+    }
+
+    victim->valid = 0;
+    arena_reset(&victim->arena);
+
+    victim->line = arena_strdup(&victim->arena, line);
+    if (!victim->line || parse_sequential_commands(line, &victim->seq, &victim->arena) != 0)
+    {
+        // Invalid lines are not cached; they are rare and cheap to reject
+        return NULL;
+    }
+
+    victim->valid = 1;
+    victim->hash = hash;
+    victim->last_used = ++s_clock;
+    victim->pins = 1;
+    return &victim->seq;
+}
+
+sequential_commands_t *parse_cache_acquire(const char *line)
+{
+    uint64_t start = stats_now();
+    sequential_commands_t *seq_cmds = lookup_or_parse(line);
+    stats_since(STAT_PARSE, start);
+    return seq_cmds;
+}
+
+void parse_cache_release(sequential_commands_t *seq_cmds)
+{
+    parse_cache_entry_t *e = entry_of(seq_cmds);
+    if (e && e->pins > 0)
+        e->pins--;
+}
+
+void parse_cache_stats(unsigned long *hits, unsigned long *misses, int *entries)
+{
+    int count = 0;
+    for (int s = 0; s < PARSE_CACHE_SETS; s++)
+    {
+        for (int w = 0; w < PARSE_CACHE_WAYS; w++)
+        {
+            if (s_entries[s][w].valid)
+                count++;
+        }
+    }
+
+    *hits = s_hits;
+    *misses = s_misses;
+    *entries = count;
+}
+
+void parse_cache_clear(void)
+{
+    for (int s = 0; s < PARSE_CACHE_SETS; s++)
+    {
+        for (int w = 0; w < PARSE_CACHE_WAYS; w++)
+        {
+            parse_cache_entry_t *e = &s_entries[s][w];
+            if (e->pins == 0)
+            {
+                e->valid = 0;
+                arena_destroy(&e->arena);
+            }
+        }
+    }
+    s_hits = 0;
+    s_misses = 0;
+}
+
+/* ############## LLM Generated Code Ends ################ */
@@ -3,770 +3,530 @@
 #include <string.h>
 #include "shell.h"
 #include "parser.h"
+#include "scan.h"
 #include <sys/wait.h>
 #include <signal.h>
 
 /* ############## LLM Generated Code Begins ############## */
 
 
-// Skip whitespace characters
-static const char *skip_whitespace(const char *str)
-{
-    while (*str == ' ' || *str == '\t' || *str == '\n' || *str == '\r')
-    {
-        str++;
-    }
-    return str;
-}
-
-// Check if character is valid for a name token
-static int is_name_char(char c)
-{
-    return c != '\0' && c != '|' && c != '&' && c != '>' && c != '<' &&
-           c != ';' && c != ' ' && c != '\t' && c != '\n' && c != '\r';
-}
+// The front end is a single pass over the line: a streaming lexer hands out
+// one token at a time and a recursive-descent parser builds the
+// sequential_commands_t tree from it directly, validating as it goes.
+//
+// Words are views into one private copy of the line.  A word is
+// NUL-terminated in place only once the lexer has moved past the byte that
+// follows it, so a separator glued to a word ("a|b") is classified before
+// it is overwritten.
 
-// Parse a name token
-static const char *parse_name(const char *str)
+typedef enum
 {
-    str = skip_whitespace(str);
-    if (!is_name_char(*str))
-        return NULL;
-
-    while (is_name_char(*str))
-    {
-        str++;
-    }
-    return str;
-}
-
-// Parse input redirection (< name)
-static const char *parse_input(const char *str)
+    TOK_WORD,   // name or "quoted string"
+    TOK_PIPE,   // |
+    TOK_AMP,    // &
+    TOK_SEMI,   // ;
+    TOK_INPUT,  // <
+    TOK_HEREDOC,    // <<
+    TOK_HERESTRING, // <<<
+    TOK_OUTPUT, // >
+    TOK_APPEND, // >>
+    TOK_PROCSUB_IN,  // <(pipeline)
+    TOK_PROCSUB_OUT, // >(pipeline)
+    TOK_INVALID,     // <( or >( without its )
+    TOK_END
+} token_type_t;
+
+typedef struct
 {
-    str = skip_whitespace(str);
-    if (*str != '<')
-        return NULL;
-
-    str++;                      // consume '<'
-    str = skip_whitespace(str); // Handle space after <
-    return parse_name(str);
-}
-
-// Parse output redirection (> name or >> name)
-static const char *parse_output(const char *str)
+    arena_t *arena;    // Owns the line copy and every node of the tree
+    char *pos;         // Next unread byte
+    char *end;         // Terminating NUL of the line copy
+    scan_cursor_t scan; // Boundary bitmaps for the bytes ahead of pos
+    char *pending_nul; // End of the previous word, terminated lazily
+    token_type_t type; // Current lookahead token
+    char *word;        // Start of the current word (TOK_WORD only)
+    char *sub_end;     // Closing ) of the current process substitution
+    char **here_docs;  // Delimiter of every << in the line, in order
+    int here_count;
+    int here_capacity;
+} lexer_t;
+
+// The ) closing the ( at open, skipping nested parentheses and quoted
+// strings; NULL if there is none
+static char *match_paren(char *open)
 {
-    str = skip_whitespace(str);
-    if (*str != '>')
-        return NULL;
-
-    str++; // consume first '>'
-    if (*str == '>')
+    int depth = 0;
+    for (char *p = open; *p; p++)
     {
-        str++; // consume second '>' for >>
+        if (*p == '"')
+        {
+            char *close = strchr(p + 1, '"');
+            if (close)
+                p = close;
+        }
+        else if (*p == '(')
+        {
+            depth++;
+        }
+        else if (*p == ')' && --depth == 0)
+        {
+            return p;
+        }
     }
-    str = skip_whitespace(str); // Handle optional whitespace after > or >>
-    return parse_name(str);
+    return NULL;
 }
 
-// Parse atomic: name (name | input | output)*
-static const char *parse_atomic(const char *str)
+// Advance to the next token
+static void lex_next(lexer_t *lx)
 {
-    // Must start with a name
-    str = parse_name(str);
-    if (!str)
-        return NULL;
-
-    // Then any number of (name | input | output)
-    while (1)
+    // Token boundaries come from the vectorized scanner in scan.c
+    char *p = (char *)scan_skip_whitespace(&lx->scan, lx->pos);
+    char *next = p + 1;
+    char *word_end = NULL;
+
+    lx->word = NULL;
+    lx->sub_end = NULL;
+    switch (*p)
     {
-        const char *next;
-        str = skip_whitespace(str);
-
-        // Try name
-        if ((next = parse_name(str)))
+    case '\0':
+        lx->type = TOK_END;
+        next = p;
+        break;
+    case '|':
+        lx->type = TOK_PIPE;
+        break;
+    case '&':
+        lx->type = TOK_AMP;
+        break;
+    case ';':
+        lx->type = TOK_SEMI;
+        break;
+    case '<':
+    case '>':
+        if (p[1] == '(')
+        {
+            // A process substitution is one argument word, <(...) itself
+            lx->type = *p == '<' ? TOK_PROCSUB_IN : TOK_PROCSUB_OUT;
+            lx->sub_end = match_paren(p + 1);
+            word_end = lx->sub_end ? lx->sub_end + 1 : NULL;
+
+            // Its terminator goes right after the ), so text glued on
+            // there (<(ls)x) would lose its first byte: a syntax error
+            if (!word_end || scan_word_end(&lx->scan, word_end) != word_end)
+            {
+                lx->type = TOK_INVALID;
+                word_end = NULL;
+                break;
+            }
+            lx->word = p;
+            next = word_end;
+            break;
+        }
+        if (*p == '>')
         {
-            str = next;
-            continue;
+            lx->type = TOK_OUTPUT;
+            if (p[1] == '>')
+            {
+                lx->type = TOK_APPEND;
+                next = p + 2;
+            }
+            break;
         }
-
-        // Try input
-        if ((next = parse_input(str)))
+        lx->type = TOK_INPUT;
+        if (p[1] == '<' && p[2] == '<')
+        {
+            lx->type = TOK_HERESTRING;
+            next = p + 3;
+        }
+        else if (p[1] == '<')
         {
-            str = next;
-            continue;
+            lx->type = TOK_HEREDOC;
+            next = p + 2;
         }
+        break;
+    default:
+        lx->type = TOK_WORD;
+        lx->word = p;
 
-        // Try output
-        if ((next = parse_output(str)))
+        // A quote at the start of a word runs to the closing quote; an
+        // unterminated quote is just an ordinary name character
+        if (*p == '"')
         {
-            str = next;
-            continue;
+            char *close = strchr(p + 1, '"');
+            if (close)
+            {
+                lx->word = p + 1;
+                word_end = close;
+                next = close + 1;
+                break;
+            }
         }
 
-        // No more matches
+        next = (char *)scan_word_end(&lx->scan, p);
+        word_end = next;
         break;
     }
 
-    return str;
+    lx->pos = next;
+    if (lx->pending_nul)
+    {
+        *lx->pending_nul = '\0';
+    }
+    lx->pending_nul = word_end;
 }
 
-// Parse cmd_group: atomic (| atomic)*
-static const char *parse_cmd_group(const char *str)
+static void lex_init(lexer_t *lx, char *buf, arena_t *arena)
 {
-    // Must start with atomic
-    str = parse_atomic(str);
-    if (!str)
-        return NULL;
+    memset(lx, 0, sizeof(*lx));
+    lx->arena = arena;
+    lx->pos = buf;
+    lx->end = buf + strlen(buf);
+    scan_cursor_init(&lx->scan, buf, lx->end);
+    lex_next(lx);
+}
 
-    // Then any number of (| atomic)
-    while (1)
+// Append an argument view to cmd->args, growing the array geometrically
+static int push_arg(lexer_t *lx, parsed_command_t *cmd, int *capacity, char *arg)
+{
+    if (cmd->arg_count == *capacity)
     {
-        const char *next;
-        str = skip_whitespace(str);
-
-        if (*str == '|' && *(str + 1) != '|')
-        {          // Single | not ||
-            str++; // consume |
-            next = parse_atomic(str);
-            if (!next)
-                return NULL; // | must be followed by atomic
-            str = next;
-        }
-        else
-        {
-            break;
-        }
+        int new_capacity = *capacity ? *capacity * 2 : 4;
+        char **tmp = arena_realloc(lx->arena, cmd->args, *capacity * sizeof(char *),
+                                   new_capacity * sizeof(char *));
+        if (!tmp)
+            return -1;
+        cmd->args = tmp;
+        *capacity = new_capacity;
     }
-
-    return str;
+    cmd->args[cmd->arg_count++] = arg;
+    return 0;
 }
 
-// Replace your parse_command function in src/parser.c with this:
-
-// Parse shell_cmd: cmd_group ((; | & | &&) cmd_group)* &?
-// Update parse_command to handle leading semicolons properly
-
-int parse_command(const char *input)
+// Append an output target to cmd->outputs (several mean fan-out)
+static int push_output(lexer_t *lx, parsed_command_t *cmd, int *capacity, char *file, int append)
 {
-    if (!input)
-        return -1;
-
-    const char *str = input;
-    str = skip_whitespace(str);
-
-    // Handle empty input
-    if (*str == '\0')
-        return -1;
-
-    // Check for leading semicolon (invalid according to grammar)
-    if (*str == ';')
+    if (cmd->output_count == *capacity)
     {
-        return -1; // Invalid: cannot start with semicolon
+        int new_capacity = *capacity ? *capacity * 2 : 2;
+        char **files = arena_realloc(lx->arena, cmd->outputs, *capacity * sizeof(char *),
+                                     new_capacity * sizeof(char *));
+        if (!files)
+            return -1;
+        cmd->outputs = files;
+        int *appends = arena_realloc(lx->arena, cmd->output_appends, *capacity * sizeof(int),
+                                     new_capacity * sizeof(int));
+        if (!appends)
+            return -1;
+        cmd->output_appends = appends;
+        *capacity = new_capacity;
     }
+    cmd->outputs[cmd->output_count] = file;
+    cmd->output_appends[cmd->output_count++] = append;
+    return 0;
+}
 
-    // Must start with cmd_group
-    str = parse_cmd_group(str);
-    if (!str)
-        return -1;
-
-    // Then any number of ((; | & | &&) cmd_group)
-    while (1)
-    {
-        const char *next;
-        str = skip_whitespace(str);
-
-        if (*str == ';')
+// Record a here-document delimiter; every one has a body to read, even
+// one overridden by a later input redirection
+static int push_here_doc(lexer_t *lx, char *delimiter)
 {
-    // Semicolon - sequential execution
-    str++; // consume ';'
-    str = skip_whitespace(str);
-
-    // Check for consecutive semicolons or empty command after semicolon
-    if (*str == '\0' || *str == ';')
+    if (lx->here_count == lx->here_capacity)
     {
-        return -1; // Invalid: trailing semicolon or consecutive semicolons
+        int new_capacity = lx->here_capacity ? lx->here_capacity * 2 : 2;
+        char **tmp = arena_realloc(lx->arena, lx->here_docs, lx->here_capacity * sizeof(char *),
+                                   new_capacity * sizeof(char *));
+        if (!tmp)
+            return -1;
+        lx->here_docs = tmp;
+        lx->here_capacity = new_capacity;
     }
-
-    next = parse_cmd_group(str);
-    if (!next)
-        return -1;
-    str = next;
+    lx->here_docs[lx->here_count++] = delimiter;
+    return 0;
 }
-        else if (*str == '&')
-        {
-            // Single & only (no && support per Q2)
-            str++;
-            str = skip_whitespace(str);
-            if (*str == '\0')
-            {
-                return 0; // Valid: & at end (background)
-            }
-            if (*str == ';')
-            {
-                // return -1;
-                continue;
-            }
-            next = parse_cmd_group(str);
-            if (!next)
-                return -1;
-            str = next;
-        }
-        else
-        {
-            break;
-        }
-    }
 
-    // Check if we consumed all input
-    str = skip_whitespace(str);
-    return (*str == '\0') ? 0 : -1;
-}
+static int parse_cmd_group(lexer_t *lx, command_pipeline_t *pipeline);
 
-// Helper function to extract a name token and advance pointer
-static char *extract_name_token(const char **str)
+// The pipeline inside the current <(...) / >(...) token, parsed from a
+// copy of its text by a lexer of its own.  Here-documents are not allowed
+// inside, as their bodies are numbered per line.
+static command_pipeline_t *parse_proc_sub(lexer_t *lx)
 {
-    *str = skip_whitespace(*str);
-    const char *start = *str;
-
-    // Check for quoted string
-    if (**str == '"')
-    {
-        start++; // Skip opening quote
-        (*str)++; // Move past opening quote
-        
-        // Find closing quote
-        while (**str && **str != '"')
-        {
-            (*str)++;
-        }
-        
-        if (**str == '"')
-        {
-            int len = *str - start;
-            char *name = malloc(len + 1);
-            if (name)
-            {
-                strncpy(name, start, len);
-                name[len] = '\0';
-            }
-            (*str)++; // Skip closing quote
-            return name;
-        }
-        else
-        {
-            // No closing quote found - treat as error or regular token
-            *str = start - 1; // Reset to before opening quote
-        }
-    }
+    size_t len = lx->sub_end - (lx->word + 2);
+    char *text = arena_alloc(lx->arena, len + 1);
+    command_pipeline_t *pipeline = arena_alloc(lx->arena, sizeof(command_pipeline_t));
+    if (!text || !pipeline)
+        return NULL;
+    memcpy(text, lx->word + 2, len);
+    text[len] = '\0';
 
-    // Handle regular (unquoted) tokens
-    if (!is_name_char(**str))
+    lexer_t inner;
+    lex_init(&inner, text, lx->arena);
+    if (parse_cmd_group(&inner, pipeline) != 0 || inner.type != TOK_END || inner.here_count > 0)
         return NULL;
+    return pipeline;
+}
 
-    while (is_name_char(**str))
-    {
-        (*str)++;
-    }
+// Append a process substitution; its word stays in args for display and
+// is replaced by the /dev/fd path at execution
+static int push_proc_sub(lexer_t *lx, parsed_command_t *cmd, int *capacity, int *arg_capacity)
+{
+    command_pipeline_t *pipeline = parse_proc_sub(lx);
+    if (!pipeline)
+        return -1;
 
-    int len = *str - start;
-    char *name = malloc(len + 1);
-    if (name)
+    if (cmd->proc_sub_count == *capacity)
     {
-        strncpy(name, start, len);
-        name[len] = '\0';
+        int new_capacity = *capacity ? *capacity * 2 : 2;
+        proc_sub_t *tmp = arena_realloc(lx->arena, cmd->proc_subs, *capacity * sizeof(proc_sub_t),
+                                        new_capacity * sizeof(proc_sub_t));
+        if (!tmp)
+            return -1;
+        cmd->proc_subs = tmp;
+        *capacity = new_capacity;
     }
-    return name;
+    proc_sub_t *sub = &cmd->proc_subs[cmd->proc_sub_count++];
+    sub->arg_index = cmd->arg_count;
+    sub->is_output = (lx->type == TOK_PROCSUB_OUT);
+    sub->pipeline = pipeline;
+    return push_arg(lx, cmd, arg_capacity, lx->word);
 }
 
-// Parse command with redirection information
-int parse_command_with_redirection(const char *input, parsed_command_t *cmd)
+// atomic: name (name | input | output | procsub)*
+static int parse_atomic(lexer_t *lx, parsed_command_t *cmd)
 {
-    if (!input || !cmd)
-        return -1;
+    int capacity = 0, output_capacity = 0, sub_capacity = 0;
 
-    // Initialize the command structure
     memset(cmd, 0, sizeof(parsed_command_t));
 
-    const char *str = input;
-    str = skip_whitespace(str);
-
-    // First token must be the command name
-    cmd->command = extract_name_token(&str);
-    if (!cmd->command)
+    // Must start with a name
+    if (lx->type != TOK_WORD)
         return -1;
-
-    // Count maximum possible arguments first
-    const char *temp = str;
-    int max_args = 0;
+    cmd->command = lx->word;
+    lex_next(lx);
 
     while (1)
     {
-        temp = skip_whitespace(temp);
-        if (*temp == '\0' || *temp == '|' || *temp == '&' || *temp == ';')
+        switch (lx->type)
+        {
+        case TOK_WORD:
+            if (push_arg(lx, cmd, &capacity, lx->word) != 0)
+                return -1;
+            lex_next(lx);
             break;
 
-        if (*temp == '<')
-        {
-            temp++;
-            temp = skip_whitespace(temp);
-            char *dummy = extract_name_token(&temp);
-            if (dummy)
-                free(dummy);
-            else
+        case TOK_PROCSUB_IN:
+        case TOK_PROCSUB_OUT:
+            if (push_proc_sub(lx, cmd, &sub_capacity, &capacity) != 0)
                 return -1;
-        }
-        else if (*temp == '>')
-        {
-            temp++;
-            if (*temp == '>')
-                temp++;
-            temp = skip_whitespace(temp);
-            char *dummy = extract_name_token(&temp);
-            if (dummy)
-                free(dummy);
-            else
+            lex_next(lx);
+            break;
+
+        case TOK_INPUT:
+            lex_next(lx);
+            if (lx->type != TOK_WORD)
                 return -1;
-        }
-        else
-        {
-            char *arg = extract_name_token(&temp);
-            if (arg)
-            {
-                max_args++;
-                free(arg);
-            }
-            else
-            {
-                break;
-            }
-        }
-    }
+            // If multiple input redirections, use only the last one
+            cmd->input_file = lx->word;
+            cmd->here_doc = cmd->here_string = NULL;
+            lex_next(lx);
+            break;
 
-    // Allocate argument array
-    if (max_args > 0)
-    {
-        cmd->args = malloc(max_args * sizeof(char *));
-        if (!cmd->args)
-        {
-            free(cmd->command);
-            return -1;
-        }
-    }
+        case TOK_HEREDOC:
+            lex_next(lx);
+            if (lx->type != TOK_WORD)
+                return -1;
+            // The body follows the line; it is numbered so the reader can
+            // hand it over at execution without touching the cached tree
+            if (push_here_doc(lx, lx->word) != 0)
+                return -1;
+            cmd->here_doc = lx->word;
+            cmd->here_index = lx->here_count;
+            cmd->input_file = cmd->here_string = NULL;
+            lex_next(lx);
+            break;
 
-    // Parse arguments and redirections
-    while (1)
-    {
-        str = skip_whitespace(str);
-        if (*str == '\0' || *str == '|' || *str == '&' || *str == ';')
+        case TOK_HERESTRING:
+            lex_next(lx);
+            if (lx->type != TOK_WORD)
+                return -1;
+            cmd->here_string = lx->word;
+            cmd->input_file = cmd->here_doc = NULL;
+            lex_next(lx);
             break;
 
-        if (*str == '<')
-        {
-            str++;
-            str = skip_whitespace(str); // Handle space after <
-            char *filename = extract_name_token(&str);
-            if (!filename)
-            {
-                cleanup_parsed_command(cmd);
+        case TOK_OUTPUT:
+        case TOK_APPEND:
+            cmd->append_mode = (lx->type == TOK_APPEND);
+            lex_next(lx);
+            if (lx->type != TOK_WORD)
                 return -1;
-            }
-            // If multiple input redirections, use only the last one
-            free(cmd->input_file);
-            cmd->input_file = filename;
-        }
-        else if (*str == '>')
-        {
-            str++;
-            int append = 0;
-            if (*str == '>')
-            {
-                str++;
-                append = 1;
-            }
-            str = skip_whitespace(str); // Handle space after > or >>
-            char *filename = extract_name_token(&str);
-            if (!filename)
-            {
-                cleanup_parsed_command(cmd);
+            // Every target gets the output; output_file is the last one
+            cmd->output_file = lx->word;
+            if (push_output(lx, cmd, &output_capacity, lx->word, cmd->append_mode) != 0)
                 return -1;
-            }
-            // If multiple output redirections, use only the last one
-            free(cmd->output_file);
-            cmd->output_file = filename;
-            cmd->append_mode = append;
-        }
-        else
-        {
-            char *arg = extract_name_token(&str);
-            if (arg)
-            {
-                cmd->args[cmd->arg_count++] = arg;
-            }
-            else
-            {
-                break;
-            }
+            lex_next(lx);
+            break;
+
+        default:
+            return 0;
         }
     }
-
-    return 0;
 }
 
-// Parse pipeline from input
-// Replace your parse_pipeline function in src/parser.c
-
-int parse_pipeline(const char *input, command_pipeline_t *pipeline)
+// cmd_group: atomic (| atomic)*
+static int parse_cmd_group(lexer_t *lx, command_pipeline_t *pipeline)
 {
-    if (!input || !pipeline)
-        return -1;
+    int capacity = 0;
 
     memset(pipeline, 0, sizeof(command_pipeline_t));
 
-    // Check if command ends with & (background execution)
-    const char *temp = input + strlen(input) - 1;
-    while (temp >= input && (*temp == ' ' || *temp == '\t' || *temp == '\n' || *temp == '\r'))
-    {
-        temp--;
-    }
-
-    if (temp >= input && *temp == '&')
-    {
-        pipeline->is_background = 1;
-
-        // Create a copy of input without the trailing &
-        int len = temp - input;
-        char *input_copy = malloc(len + 1);
-        if (!input_copy)
-            return -1;
-        strncpy(input_copy, input, len);
-        input_copy[len] = '\0';
-
-        // Parse the command without the &
-        int result = parse_pipeline(input_copy, pipeline);
-        pipeline->is_background = 1; // Ensure this is set
-        free(input_copy);
-        return result;
-    }
-
-    // Count separators (both | and &) to determine number of commands
-    temp = input;
-    int separator_count = 0;
-
-    while (*temp)
+    while (1)
     {
-        if (*temp == '|' && *(temp + 1) != '|')
+        if (pipeline->cmd_count == capacity)
         {
-            separator_count++;
-        }
-        else if (*temp == '&')
-        {
-            // Check if this & is at the end (already handled above) or in the middle
-            const char *check = temp + 1;
-            while (*check == ' ' || *check == '\t' || *check == '\n' || *check == '\r')
-            {
-                check++;
-            }
-            if (*check != '\0')
-            { // Not at the end, it's a separator
-                separator_count++;
-                // For & separator, mark as background
-                pipeline->is_background = 1;
-            }
+            int new_capacity = capacity ? capacity * 2 : 2;
+            parsed_command_t *tmp = arena_realloc(lx->arena, pipeline->commands,
+                                                  capacity * sizeof(parsed_command_t),
+                                                  new_capacity * sizeof(parsed_command_t));
+            if (!tmp)
+                return -1;
+            pipeline->commands = tmp;
+            capacity = new_capacity;
         }
-        temp++;
-    }
-
-    int cmd_count = separator_count + 1;
 
-    // Allocate command array
-    pipeline->commands = malloc(cmd_count * sizeof(parsed_command_t));
-    if (!pipeline->commands)
-        return -1;
+        parsed_command_t *cmd = &pipeline->commands[pipeline->cmd_count++];
+        if (parse_atomic(lx, cmd) != 0)
+            return -1;
 
-    pipeline->cmd_count = cmd_count;
+        if (lx->type != TOK_PIPE)
+            return 0;
+        lex_next(lx); // consume |, which must be followed by atomic
+    }
+}
 
-    // Parse each command in the pipeline
-    const char *str = input;
-    const char *cmd_start = str;
-    int cmd_index = 0;
+// shell_cmd: cmd_group ((; | &) cmd_group)* &?
+static int parse_shell_cmd(lexer_t *lx, sequential_commands_t *seq_cmds)
+{
+    int capacity = 0;
 
-    while (*str && cmd_index < cmd_count)
+    while (1)
     {
-        // Find the end of current command (next separator or end of string)
-        const char *cmd_end = str;
-        while (*cmd_end)
+        if (seq_cmds->pipeline_count == capacity)
         {
-            if (*cmd_end == '|' && *(cmd_end + 1) != '|')
-            {
-                break; // Found pipe separator
-            }
-            else if (*cmd_end == '&')
-            {
-                // Check if this & is a separator (not at the end)
-                const char *check = cmd_end + 1;
-                while (*check == ' ' || *check == '\t' || *check == '\n' || *check == '\r')
-                {
-                    check++;
-                }
-                if (*check != '\0')
-                { // Not at the end, it's a separator
-                    break;
-                }
-            }
-            cmd_end++;
+            int new_capacity = capacity ? capacity * 2 : 2;
+            command_pipeline_t *tmp = arena_realloc(lx->arena, seq_cmds->pipelines,
+                                                    capacity * sizeof(command_pipeline_t),
+                                                    new_capacity * sizeof(command_pipeline_t));
+            if (!tmp)
+                return -1;
+            seq_cmds->pipelines = tmp;
+            capacity = new_capacity;
         }
 
-        // Extract the current command string
-        int cmd_len = cmd_end - cmd_start;
-        char *cmd_str = malloc(cmd_len + 1);
-        if (!cmd_str)
-        {
-            cleanup_pipeline(pipeline);
+        command_pipeline_t *pipeline = &seq_cmds->pipelines[seq_cmds->pipeline_count++];
+        if (parse_cmd_group(lx, pipeline) != 0)
             return -1;
-        }
-        strncpy(cmd_str, cmd_start, cmd_len);
-        cmd_str[cmd_len] = '\0';
 
-        // Parse this command
-        if (parse_command_with_redirection(cmd_str, &pipeline->commands[cmd_index]) != 0)
+        if (lx->type == TOK_AMP)
         {
-            free(cmd_str);
-            cleanup_pipeline(pipeline);
-            return -1;
+            // & runs the group in the background; it may end the line or be
+            // followed by another group, optionally after a ;
+            pipeline->is_background = 1;
+            lex_next(lx);
+            if (lx->type == TOK_END)
+                return 0;
+            if (lx->type == TOK_SEMI)
+                lex_next(lx);
         }
-
-        free(cmd_str);
-        cmd_index++;
-
-        // Move to next command
-        if (*cmd_end == '|' || *cmd_end == '&')
+        else if (lx->type == TOK_SEMI)
         {
-            str = cmd_end + 1;
-            cmd_start = str;
+            lex_next(lx);
         }
         else
         {
-            break;
+            // Anything else must be the end of the input
+            return (lx->type == TOK_END) ? 0 : -1;
         }
     }
-
-    return 0;
 }
-// Cleanup function for parsed command
-void cleanup_parsed_command(parsed_command_t *cmd)
-{
-    if (!cmd)
-        return;
-
-    free(cmd->command);
-    for (int i = 0; i < cmd->arg_count; i++)
-    {
-        free(cmd->args[i]);
-    }
-    free(cmd->args);
-    free(cmd->input_file);
-    free(cmd->output_file);
 
-    memset(cmd, 0, sizeof(parsed_command_t));
-}
+// Scratch arena for parse_command, which only needs the verdict
+static arena_t s_validate_arena;
 
-// Cleanup function for pipeline
-void cleanup_pipeline(command_pipeline_t *pipeline)
+// Validate a full input line against the shell grammar
+int parse_command(const char *input)
 {
-    if (!pipeline)
-        return;
+    sequential_commands_t seq_cmds;
 
-    for (int i = 0; i < pipeline->cmd_count; i++)
-    {
-        cleanup_parsed_command(&pipeline->commands[i]);
-    }
-    free(pipeline->commands);
-
-    memset(pipeline, 0, sizeof(command_pipeline_t));
+    int result = parse_sequential_commands(input, &seq_cmds, &s_validate_arena);
+    arena_reset(&s_validate_arena);
+    return result;
 }
 
-// part d
+// Parse a single atomic command with redirection information; parsing stops
+// at the first separator
+int parse_command_with_redirection(const char *input, parsed_command_t *cmd, arena_t *arena)
+{
+    if (!input || !cmd)
+        return -1;
 
-// Add these functions to the end of src/parser.c
+    memset(cmd, 0, sizeof(parsed_command_t));
 
-// Parse sequential commands separated by semicolons
-// Replace your parse_sequential_commands function in src/parser.c
+    // Copy the line once; every token of the parse is a view into it
+    char *buf = arena_strdup(arena, input);
+    if (!buf)
+        return -1;
 
-// Replace your parse_sequential_commands function in src/parser.c with this fixed version:
+    lexer_t lx;
+    lex_init(&lx, buf, arena);
+    return parse_atomic(&lx, cmd);
+}
 
-int parse_sequential_commands(const char *input, sequential_commands_t *seq_cmds)
+// Parse a pipeline, optionally followed by a trailing & for background
+int parse_pipeline(const char *input, command_pipeline_t *pipeline, arena_t *arena)
 {
-    if (!input || !seq_cmds)
+    if (!input || !pipeline)
         return -1;
 
-    memset(seq_cmds, 0, sizeof(sequential_commands_t));
-
-    // Count separators (both ; and &) to determine number of command groups
-    const char *temp = input;
-    int separator_count = 0;
-
-    while (*temp)
-    {
-        if (*temp == ';')
-        {
-            separator_count++;
-        }
-        else if (*temp == '&')
-        {
-            // Check if this & is not at the very end (trailing & is handled in pipeline parsing)
-            const char *check = temp + 1;
-            while (*check == ' ' || *check == '\t' || *check == '\n' || *check == '\r')
-            {
-                check++;
-            }
-            // If there's more content after &, it's a separator
-            if (*check != '\0')
-            {
-                separator_count++;
-            }
-        }
-        temp++;
-    }
-
-    int max_pipeline_count = separator_count + 1;
+    memset(pipeline, 0, sizeof(command_pipeline_t));
 
-    // Allocate pipeline array
-    seq_cmds->pipelines = malloc(max_pipeline_count * sizeof(command_pipeline_t));
-    if (!seq_cmds->pipelines)
+    char *buf = arena_strdup(arena, input);
+    if (!buf)
         return -1;
 
-    // Parse each command group separated by ; or &
-    const char *str = input;
-    const char *cmd_start = str;
-    int pipeline_index = 0;
+    lexer_t lx;
+    lex_init(&lx, buf, arena);
 
-    while (*str)
+    if (parse_cmd_group(&lx, pipeline) != 0)
+        return -1;
+    if (lx.type == TOK_AMP)
     {
-        // Find the end of current command group (next ; or & or end of string)
-        const char *cmd_end = str;
-        while (*cmd_end)
-        {
-            if (*cmd_end == ';')
-            {
-                break; // Found semicolon separator
-            }
-            else if (*cmd_end == '&')
-            {
-                // Check if this & is a separator (not at the end)
-                const char *check = cmd_end + 1;
-                while (*check == ' ' || *check == '\t' || *check == '\n' || *check == '\r')
-                {
-                    check++;
-                }
-                if (*check != '\0')
-                { // Not at the end, it's a separator
-                    break;
-                }
-            }
-            cmd_end++;
-        }
-
-        // Extract the current command group string
-        int cmd_len = cmd_end - cmd_start;
-        char *cmd_str = malloc(cmd_len + 1);
-        if (!cmd_str)
-        {
-            seq_cmds->pipeline_count = pipeline_index;
-            cleanup_sequential_commands(seq_cmds);
-            return -1;
-        }
-        strncpy(cmd_str, cmd_start, cmd_len);
-        cmd_str[cmd_len] = '\0';
-
-        // Trim whitespace from command string
-        char *trimmed_cmd = cmd_str;
-        while (*trimmed_cmd == ' ' || *trimmed_cmd == '\t' || *trimmed_cmd == '\n' || *trimmed_cmd == '\r')
-        {
-            trimmed_cmd++;
-        }
-        char *end = trimmed_cmd + strlen(trimmed_cmd) - 1;
-        while (end > trimmed_cmd && (*end == ' ' || *end == '\t' || *end == '\n' || *end == '\r'))
-        {
-            *end = '\0';
-            end--;
-        }
-
-        // Handle empty commands - just skip them
-        if (strlen(trimmed_cmd) == 0)
-        {
-            free(cmd_str);
-            // Move to next command group
-            if (*cmd_end == ';' || *cmd_end == '&')
-            {
-                str = cmd_end + 1;
-                cmd_start = str;
-            }
-            else
-            {
-                break;
-            }
-            continue;
-        }
-
-        // If this command group was separated by &, add & to make it background
-        if (*cmd_end == '&')
-        {
-            // Check if the command doesn't already end with &
-            char *check_end = trimmed_cmd + strlen(trimmed_cmd) - 1;
-            while (check_end > trimmed_cmd && (*check_end == ' ' || *check_end == '\t'))
-            {
-                check_end--;
-            }
-            if (*check_end != '&')
-            {
-                // Add & to make it background
-                strcat(trimmed_cmd, " &");
-            }
-        }
-
-        // Parse this command group as a pipeline
-        if (parse_pipeline(trimmed_cmd, &seq_cmds->pipelines[pipeline_index]) != 0)
-        {
-            free(cmd_str);
-            seq_cmds->pipeline_count = pipeline_index;
-            cleanup_sequential_commands(seq_cmds);
-            return -1;
-        }
-
-        free(cmd_str);
-        pipeline_index++;
-
-        // Move to next command group
-        if (*cmd_end == ';' || *cmd_end == '&')
-        {
-            str = cmd_end + 1;
-            cmd_start = str;
-        }
-        else
-        {
-            break;
-        }
+        pipeline->is_background = 1;
+        lex_next(&lx);
     }
-
-    // Update the actual count
-    seq_cmds->pipeline_count = pipeline_index;
-
-    return 0;
+    return (lx.type == TOK_END) ? 0 : -1;
 }
 
-// Cleanup function for sequential commands
-void cleanup_sequential_commands(sequential_commands_t *seq_cmds)
+// Parse a full input line into its sequence of pipelines.  This is the one
+// entry point the REPL uses: a non-zero return means invalid syntax.
+int parse_sequential_commands(const char *input, sequential_commands_t *seq_cmds, arena_t *arena)
 {
-    if (!seq_cmds)
-        return;
-
-    for (int i = 0; i < seq_cmds->pipeline_count; i++)
-    {
-        cleanup_pipeline(&seq_cmds->pipelines[i]);
-    }
-    free(seq_cmds->pipelines);
+    if (!input || !seq_cmds)
+        return -1;
 
     memset(seq_cmds, 0, sizeof(sequential_commands_t));
+
+    char *buf = arena_strdup(arena, input);
+    if (!buf)
+        return -1;
+
+    lexer_t lx;
+    lex_init(&lx, buf, arena);
+    if (parse_shell_cmd(&lx, seq_cmds) != 0)
+        return -1;
+
+    seq_cmds->here_docs = lx.here_docs;
+    seq_cmds->here_doc_count = lx.here_count;
+    return 0;
 }
 
 /* ############## LLM Generated Code Ends ################ */
@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include "pathcache.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+// Used by execvp when PATH is unset
+#define DEFAULT_PATH "/bin:/usr/bin"
+
+typedef struct path_entry
+{
+    struct path_entry *next;
+    uint64_t hash;
+    char *name;
+    char *path;             // NULL for a cached miss
+    uint64_t dirs_stamp;    // For misses: PATH directory state when searched
+    unsigned long hits;
+} path_entry_t;
+
+static path_entry_t *s_buckets[PATH_CACHE_BUCKETS];
+static char *s_path_value = NULL;   // PATH the table was filled under
+static uint64_t s_dirs_stamp = 0;
+static uint64_t s_stamp_time = 0;   // When s_dirs_stamp was computed (ms)
+static char s_uncached[PATH_MAX];
+
+// FNV-1a over the command name
+static uint64_t hash_name(const char *name)
+{
+    uint64_t h = 1469598103934665603ULL;
+    while (*name)
+    {
+        h ^= (unsigned char)*name++;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static const char *current_path(void)
+{
+    const char *path = getenv("PATH");
+    return path ? path : DEFAULT_PATH;
+}
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Combined identity and mtime of every PATH directory; any binary added
+// to or removed from one of them changes it
+static uint64_t dirs_stamp(const char *path)
+{
+    uint64_t h = 1469598103934665603ULL;
+    char dir[PATH_MAX];
+
+    while (*path)
+    {
+        size_t len = strcspn(path, ":");
+        if (len == 0)
+            strcpy(dir, ".");
+        else if (len < sizeof dir)
+            memcpy(dir, path, len), dir[len] = '\0';
+        else
+            dir[0] = '\0';
+
+        struct stat st;
+        if (dir[0] && stat(dir, &st) == 0)
+        {
+            h = (h ^ (uint64_t)st.st_ino) * 1099511628211ULL;
+            h = (h ^ (uint64_t)st.st_mtim.tv_sec) * 1099511628211ULL;
+            h = (h ^ (uint64_t)st.st_mtim.tv_nsec) * 1099511628211ULL;
+        }
+        path += len;
+        if (*path == ':')
+            path++;
+    }
+    return h;
+}
+
+static uint64_t current_dirs_stamp(void)
+{
+    uint64_t now = now_ms();
+    if (s_stamp_time == 0 || now - s_stamp_time >= PATH_CACHE_RECHECK_MS)
+    {
+        s_dirs_stamp = dirs_stamp(current_path());
+        s_stamp_time = now;
+    }
+    return s_dirs_stamp;
+}
+
+static int is_executable(const char *file)
+{
+    struct stat st;
+    return stat(file, &st) == 0 && S_ISREG(st.st_mode) && access(file, X_OK) == 0;
+}
+
+// Walk PATH for name.  On success the full path is left in out and
+// *relative says whether it came from a relative PATH entry (such results
+// depend on the cwd and are not cached).
+static int search_path(const char *name, char *out, size_t size, int *relative)
+{
+    const char *path = current_path();
+
+    for (;;)
+    {
+        size_t len = strcspn(path, ":");
+        int n;
+        if (len == 0)
+            n = snprintf(out, size, "%s", name);
+        else
+            n = snprintf(out, size, "%.*s/%s", (int)len, path, name);
+
+        if (n > 0 && (size_t)n < size && is_executable(out))
+        {
+            *relative = len == 0 || path[0] != '/';
+            return 0;
+        }
+
+        path += len;
+        if (*path != ':')
+            return -1;
+        path++;
+    }
+}
+
+// Drop everything if PATH is not what the table was built under
+static void check_path_value(void)
+{
+    const char *path = current_path();
+    if (s_path_value && strcmp(s_path_value, path) == 0)
+        return;
+
+    path_cache_clear();
+    s_path_value = strdup(path);
+}
+
+static path_entry_t **find_slot(const char *name, uint64_t hash)
+{
+    path_entry_t **slot = &s_buckets[hash % PATH_CACHE_BUCKETS];
+    while (*slot && ((*slot)->hash != hash || strcmp((*slot)->name, name) != 0))
+        slot = &(*slot)->next;
+    return slot;
+}
+
+static void free_entry(path_entry_t *e)
+{
+    free(e->name);
+    free(e->path);
+    free(e);
+}
+
+// Search PATH and store the outcome in a fresh entry.  Returns the entry,
+// or NULL when the result cannot be cached; s_uncached then holds a
+// relative hit, or is empty for a miss.
+static path_entry_t *resolve(const char *name, uint64_t hash)
+{
+    char found[PATH_MAX];
+    int relative = 0;
+    int ok = search_path(name, found, sizeof found, &relative) == 0;
+
+    s_uncached[0] = '\0';
+    if (ok && relative)
+    {
+        strcpy(s_uncached, found);
+        return NULL;
+    }
+
+    path_entry_t *e = calloc(1, sizeof *e);
+    if (!e || !(e->name = strdup(name)) || (ok && !(e->path = strdup(found))))
+    {
+        if (e)
+            free_entry(e);
+        if (ok)
+            strcpy(s_uncached, found);
+        return NULL;
+    }
+
+    e->hash = hash;
+    if (!ok)
+        e->dirs_stamp = current_dirs_stamp();
+
+    path_entry_t **slot = &s_buckets[hash % PATH_CACHE_BUCKETS];
+    e->next = *slot;
+    *slot = e;
+    return e;
+}
+
+const char *path_cache_lookup(const char *name)
+{
+    if (strchr(name, '/'))
+        return name;
+    if (name[0] == '\0')
+        return NULL;
+
+    check_path_value();
+
+    uint64_t hash = hash_name(name);
+    path_entry_t **slot = find_slot(name, hash);
+    path_entry_t *e = *slot;
+
+    // A cached miss holds only while the PATH directories are unchanged
+    if (e && !e->path && e->dirs_stamp != current_dirs_stamp())
+    {
+        *slot = e->next;
+        free_entry(e);
+        e = NULL;
+    }
+
+    if (!e)
+    {
+        e = resolve(name, hash);
+        if (!e)
+            return s_uncached[0] ? s_uncached : NULL;
+    }
+
+    if (e->path)
+        e->hits++;
+    return e->path;
+}
+
+int path_cache_add(const char *name)
+{
+    if (strchr(name, '/'))
+        return is_executable(name) ? 0 : -1;
+
+    path_cache_forget(name);
+    path_entry_t *e = resolve(name, hash_name(name));
+    return (e && e->path) || s_uncached[0] ? 0 : -1;
+}
+
+void path_cache_forget(const char *name)
+{
+    check_path_value();
+
+    path_entry_t **slot = find_slot(name, hash_name(name));
+    path_entry_t *e = *slot;
+    if (e)
+    {
+        *slot = e->next;
+        free_entry(e);
+    }
+}
+
+void path_cache_clear(void)
+{
+    for (int i = 0; i < PATH_CACHE_BUCKETS; i++)
+    {
+        while (s_buckets[i])
+        {
+            path_entry_t *e = s_buckets[i];
+            s_buckets[i] = e->next;
+            free_entry(e);
+        }
+    }
+    free(s_path_value);
+    s_path_value = NULL;
+    s_stamp_time = 0;
+}
+
+void path_cache_print(void)
+{
+    int printed = 0;
+
+    for (int i = 0; i < PATH_CACHE_BUCKETS; i++)
+    {
+        for (path_entry_t *e = s_buckets[i]; e; e = e->next)
+        {
+            if (!e->path)
+                continue;
+            if (!printed++)
+                printf("hits\tcommand\n");
+            printf("%4lu\t%s\n", e->hits, e->path);
+        }
+    }
+
+    if (!printed)
+        printf("hash: hash table empty\n");
+}
+
+/* ############## LLM Generated Code Ends ################ */
@@ -0,0 +1,274 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include "shell.h"
+#include "profile.h"
+#include "events.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+#define PROFILE_LABEL_MAX 24
+
+// A writer blocks once less than a page is free
+#define PROFILE_PIPE_SLACK 4096
+
+typedef struct
+{
+    pid_t pid;
+    char label[PROFILE_LABEL_MAX + 1];
+    int alive;              // Still there at the last sample
+    double cpu;             // CPU seconds at the last sample
+    unsigned long long rchar, wchar;    // Bytes read and written, likewise
+    double lifetime;        // Seconds of samples it was running in
+    double busy;            // On a CPU or in disk wait
+    double in_wait, out_wait;   // Sleeping on an empty input / full output pipe
+    double out_fill;        // Sum of output pipe fill fractions, per sample
+    int out_samples;
+} stage_profile_t;
+
+struct profile
+{
+    stage_profile_t *stages;
+    int count;
+    struct timespec started, last;
+    long *fills;            // Per pipe this sample: bytes queued, -1 unknown
+    long *capacities;
+};
+
+static double seconds_between(const struct timespec *a, const struct timespec *b)
+{
+    return (b->tv_sec - a->tv_sec) + (b->tv_nsec - a->tv_nsec) / 1e9;
+}
+
+// State letter and CPU seconds of pid; 0 if it is gone or a zombie
+static char read_stat(pid_t pid, double *cpu)
+{
+    char path[64], buf[1024];
+    snprintf(path, sizeof path, "/proc/%d/stat", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return 0;
+
+    // The command name (field 2) may contain spaces, so fields are counted
+    // from its closing parenthesis: state, then utime and stime 11 later
+    char state = 0;
+    unsigned long utime, stime;
+    char *p = fgets(buf, sizeof buf, f) ? strrchr(buf, ')') : NULL;
+    if (p && sscanf(p + 2, "%c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                    &state, &utime, &stime) == 3)
+        *cpu = (double)(utime + stime) / sysconf(_SC_CLK_TCK);
+    fclose(f);
+    return state == 'Z' ? 0 : state;
+}
+
+static void read_io(pid_t pid, unsigned long long *rchar, unsigned long long *wchar)
+{
+    char path[64], buf[128];
+    snprintf(path, sizeof path, "/proc/%d/io", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return;
+    while (fgets(buf, sizeof buf, f))
+    {
+        if (sscanf(buf, "rchar: %llu", rchar) == 1)
+            continue;
+        sscanf(buf, "wchar: %llu", wchar);
+    }
+    fclose(f);
+}
+
+// Bytes queued in the pipe on descriptor fd of pid, and the pipe's size.
+// The pipe is opened afresh through /proc for every sample: a read end
+// held across samples would keep its writer from ever seeing EPIPE.
+static long pipe_fill(pid_t pid, int fd, long *capacity)
+{
+    char path[64];
+    snprintf(path, sizeof path, "/proc/%d/fd/%d", (int)pid, fd);
+    int pipe_fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (pipe_fd == -1)
+        return -1;
+
+    long fill = -1;
+    int queued;
+    struct stat st;
+    if (fstat(pipe_fd, &st) == 0 && S_ISFIFO(st.st_mode) && ioctl(pipe_fd, FIONREAD, &queued) == 0)
+    {
+        fill = queued;
+        *capacity = fcntl(pipe_fd, F_GETPIPE_SZ);
+    }
+    close(pipe_fd);
+    return fill;
+}
+
+static int pipe_full(const profile_t *p, int pipe)
+{
+    return p->fills[pipe] >= 0 && p->capacities[pipe] > 0 &&
+           p->fills[pipe] >= p->capacities[pipe] - PROFILE_PIPE_SLACK;
+}
+
+// Ticker: one sample of every stage still running
+static void sample(void *arg)
+{
+    profile_t *p = arg;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double dt = seconds_between(&p->last, &now);
+    p->last = now;
+
+    // Pipe k joins stage k to stage k + 1; it is looked up through the
+    // reader, or the writer once the reader is gone
+    for (int k = 0; k < p->count - 1; k++)
+    {
+        stage_profile_t *reader = &p->stages[k + 1], *writer = &p->stages[k];
+        p->fills[k] = -1;
+        if (reader->alive)
+            p->fills[k] = pipe_fill(reader->pid, STDIN_FILENO, &p->capacities[k]);
+        if (p->fills[k] == -1 && writer->alive)
+            p->fills[k] = pipe_fill(writer->pid, STDOUT_FILENO, &p->capacities[k]);
+    }
+
+    for (int i = 0; i < p->count; i++)
+    {
+        stage_profile_t *s = &p->stages[i];
+        if (!s->alive)
+            continue;
+
+        char state = read_stat(s->pid, &s->cpu);
+        if (!state)
+        {
+            s->alive = 0;
+            continue;
+        }
+        read_io(s->pid, &s->rchar, &s->wchar);
+
+        // A stopped stage (Ctrl-Z) is not running at all
+        if (state == 'T' || state == 't')
+            continue;
+        s->lifetime += dt;
+
+        if (i < p->count - 1 && p->fills[i] >= 0 && p->capacities[i] > 0)
+        {
+            s->out_fill += (double)p->fills[i] / p->capacities[i];
+            s->out_samples++;
+        }
+
+        if (state == 'R' || state == 'D')
+            s->busy += dt;
+        else if (i > 0 && p->fills[i - 1] == 0)
+            s->in_wait += dt;
+        else if (i < p->count - 1 && pipe_full(p, i))
+            s->out_wait += dt;
+    }
+}
+
+static void make_label(char *label, const parsed_command_t *cmd)
+{
+    size_t len = snprintf(label, PROFILE_LABEL_MAX + 1, "%s", cmd->command);
+    for (int i = 0; i < cmd->arg_count && len < PROFILE_LABEL_MAX; i++)
+        len += snprintf(label + len, PROFILE_LABEL_MAX + 1 - len, " %s", cmd->args[i]);
+}
+
+profile_t *profile_start(const pid_t *pids, const parsed_command_t *commands, int count)
+{
+    profile_t *p = arena_alloc(&g_line_arena, sizeof *p);
+    if (!p)
+        return NULL;
+    p->count = count;
+    p->stages = arena_alloc(&g_line_arena, count * sizeof *p->stages);
+    p->fills = arena_alloc(&g_line_arena, count * sizeof *p->fills);
+    p->capacities = arena_alloc(&g_line_arena, count * sizeof *p->capacities);
+    if (!p->stages || !p->fills || !p->capacities)
+    {
+        perror("malloc failed");
+        return NULL;
+    }
+    memset(p->stages, 0, count * sizeof *p->stages);
+
+    for (int i = 0; i < count; i++)
+    {
+        p->stages[i].pid = pids[i];
+        p->stages[i].alive = pids[i] > 0;
+        make_label(p->stages[i].label, &commands[i]);
+        p->capacities[i] = 0;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &p->started);
+    p->last = p->started;
+    if (events_set_ticker(sample, p, PROFILE_INTERVAL_MS) != 0)
+        return NULL;
+    return p;
+}
+
+static void print_seconds(double value, int known)
+{
+    if (known)
+        fprintf(stderr, " %8.2fs", value);
+    else
+        fprintf(stderr, " %9s", "-");
+}
+
+void profile_finish(profile_t *p)
+{
+    events_set_ticker(NULL, NULL, 0);
+    if (!p)
+        return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    fflush(stdout);
+    fprintf(stderr, "profile: %.3fs, %d stage%s, sampled every %dms\n",
+            seconds_between(&p->started, &now), p->count, p->count == 1 ? "" : "s",
+            PROFILE_INTERVAL_MS);
+    fprintf(stderr, "  #  %-*s  %5s %9s %9s %9s %9s %9s %8s\n", PROFILE_LABEL_MAX, "command",
+            "cpu%", "busy", "in-wait", "out-wait", "in MB/s", "out MB/s", "out-pipe");
+
+    int bottleneck = -1;
+    double worst = 0;
+    for (int i = 0; i < p->count; i++)
+    {
+        stage_profile_t *s = &p->stages[i];
+        fprintf(stderr, "%3d  %-*s", i + 1, PROFILE_LABEL_MAX, s->label);
+        if (s->pid <= 0)
+        {
+            fprintf(stderr, "  (ran in the shell)\n");
+            continue;
+        }
+        if (s->lifetime <= 0)
+        {
+            fprintf(stderr, "  (finished before the first sample)\n");
+            continue;
+        }
+
+        fprintf(stderr, "  %4.0f%%", 100 * s->cpu / s->lifetime);
+        print_seconds(s->busy, 1);
+        print_seconds(s->in_wait, i > 0);
+        print_seconds(s->out_wait, i < p->count - 1);
+        fprintf(stderr, " %9.1f %9.1f", s->rchar / s->lifetime / 1e6, s->wchar / s->lifetime / 1e6);
+        if (s->out_samples > 0)
+            fprintf(stderr, " %7.0f%%\n", 100 * s->out_fill / s->out_samples);
+        else
+            fprintf(stderr, " %8s\n", "-");
+
+        // Time not spent waiting on a neighbour is time the others waited
+        // for this stage
+        double unblocked = s->lifetime - s->in_wait - s->out_wait;
+        if (unblocked > worst)
+        {
+            worst = unblocked;
+            bottleneck = i;
+        }
+    }
+
+    if (p->count > 1 && bottleneck != -1)
+        fprintf(stderr, "bottleneck: stage %d (%s)\n", bottleneck + 1, p->stages[bottleneck].label);
+    fflush(stderr);
+}
+
+/* ############## LLM Generated Code Ends ################ */
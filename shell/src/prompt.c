@@ -6,6 +6,7 @@
 #include <limits.h>
 #include "shell.h"
 #include "prompt.h"
+#include "stats.h"
 #include <sys/stat.h>
 /* ############## LLM Generated Code Begins ############## */
 
@@ -65,19 +66,62 @@ static void tilde_path(const char *cwd, const char *home, char *out, size_t outl
     snprintf(out, outlen, "%s", cwd);
 }
 
-int prompt_build(char *buf, size_t buflen) {
-    if (!buf || buflen < 8) return -1;
-    
+// The prompt only changes when the cwd does, so it is cached and rebuilt
+// when hop invalidates it, or when the directory it was built for no
+// longer resolves to the same inode (renamed or removed underneath us).
+static char s_prompt[SHELL_PROMPT_MAX];
+static int s_prompt_valid = 0;
+static char s_prompt_cwd[PATH_MAX];
+static dev_t s_prompt_dev;
+static ino_t s_prompt_ino;
+
+void prompt_invalidate(void) {
+    s_prompt_valid = 0;
+}
+
+static int prompt_cwd_unchanged(void) {
+    struct stat st;
+    return stat(s_prompt_cwd, &st) == 0 &&
+           st.st_dev == s_prompt_dev && st.st_ino == s_prompt_ino;
+}
+
+static int prompt_rebuild(void) {
     char cwd[PATH_MAX] = {0};
     char shown[PATH_MAX] = {0};
+    struct stat st;
     
+    s_prompt_valid = 0;
     if (!getcwd(cwd, sizeof cwd)) {
         strncpy(cwd, "?", sizeof cwd - 1);
         cwd[sizeof cwd - 1] = '\0';
     }
     
     tilde_path(cwd, g_shell_home, shown, sizeof shown);
-    int n = snprintf(buf, buflen, "<%s@%s:%s> ", s_user, s_host, shown);
-    return (n < 0 || (size_t)n >= buflen) ? -1 : 0;
+    int n = snprintf(s_prompt, sizeof s_prompt, "<%s@%s:%s> ", s_user, s_host, shown);
+    if (n < 0 || (size_t)n >= sizeof s_prompt) return -1;
+    
+    // Only an identifiable cwd can be revalidated; otherwise rebuild next time
+    if (cwd[0] == '/' && stat(cwd, &st) == 0) {
+        strncpy(s_prompt_cwd, cwd, sizeof s_prompt_cwd - 1);
+        s_prompt_cwd[sizeof s_prompt_cwd - 1] = '\0';
+        s_prompt_dev = st.st_dev;
+        s_prompt_ino = st.st_ino;
+        s_prompt_valid = 1;
+    }
+    return 0;
+}
+
+int prompt_build(char *buf, size_t buflen) {
+    if (!buf || buflen < 8) return -1;
+    
+    uint64_t start = stats_now();
+    int failed = (!s_prompt_valid || !prompt_cwd_unchanged()) && prompt_rebuild() != 0;
+    stats_since(STAT_PROMPT, start);
+    if (failed) return -1;
+    
+    size_t n = strlen(s_prompt);
+    if (n >= buflen) return -1;
+    memcpy(buf, s_prompt, n + 1);
+    return 0;
 }
 /* ############## LLM Generated Code Ends ################ */
\ No newline at end of file
@@ -1,4 +1,5 @@
 // File: src/redirection.c
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -6,11 +7,44 @@
 #include <fcntl.h>
 #include <sys/wait.h>
 #include <errno.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
 #include "../include/redirection.h"
 #include "../include/shell.h"
 #include "../include/commands.h"
+#include "../include/launch.h"
+#include "../include/builtins.h"
+#include "../include/events.h"
+#include "../include/usage.h"
+#include "../include/stats.h"
+#include "../include/trace.h"
+#include "../include/fanout.h"
+#include "../include/heredoc.h"
+#include "../include/fastpath.h"
+#include "../include/profile.h"
+#include "../include/memo.h"
+#include "../include/pathcache.h"
 /* ############## LLM Generated Code Begins ############## */
 
+// Resource usage of the current foreground processes.  Reset for every
+// foreground command, except inside `time`, which reports it at the end.
+static job_usage_t s_fg_usage;
+static int s_timing = 0;
+
+// Set while `profile` runs its pipeline: the next foreground pipeline is
+// sampled, even a single command
+static int s_profiling = 0;
+
+// Set when a foreground command was stopped rather than finished
+static int s_fg_stopped = 0;
+
+static void start_foreground_usage(void)
+{
+    if (!s_timing)
+        usage_start(&s_fg_usage);
+}
+
 // Handle input redirection (Part C.1)
 int handle_input_redirection(const char *filename)
 {
@@ -19,11 +53,10 @@ int handle_input_redirection(const char *filename)
         return 0; // No input redirection
     }
 
-    // Open the input file for reading using O_RDONLY flag
-    int input_fd = open(filename, O_RDONLY);
+    // Open the input file for reading (reports its own error)
+    int input_fd = launch_open_input(filename);
     if (input_fd == -1)
     {
-        fprintf(stderr, "No such file or directory\n");
         return -1;
     }
 
@@ -48,22 +81,10 @@ int handle_output_redirection(const char *filename, int append_mode)
         return 0; // No output redirection
     }
 
-    int output_fd;
-
-    if (append_mode)
-    {
-        // >> redirection - create/append to file
-        output_fd = open(filename, O_WRONLY | O_CREAT | O_APPEND, 0644);
-    }
-    else
-    {
-        // > redirection - create/truncate file
-        output_fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-    }
-
+    // > truncates, >> appends (reports its own error)
+    int output_fd = launch_open_output(filename, append_mode);
     if (output_fd == -1)
     {
-        printf("Unable to create file for writing\n");
         return -1;
     }
 
@@ -80,79 +101,382 @@ int handle_output_redirection(const char *filename, int append_mode)
     return 0;
 }
 
-// Check if command is a built-in command
-static int is_builtin_command(const char *command)
+// Build a NULL-terminated argv for cmd in the line arena
+static char **build_argv(parsed_command_t *cmd)
 {
-    return (strcmp(command, "hop") == 0 ||
-            strcmp(command, "reveal") == 0 ||
-            strcmp(command, "log") == 0 ||
-            strcmp(command, "activities") == 0 ||
-            strcmp(command, "ping") == 0 ||
-            strcmp(command, "fg") == 0 ||
-            strcmp(command, "bg") == 0);
+    char **args = arena_alloc(&g_line_arena, (cmd->arg_count + 2) * sizeof(char *));
+    if (!args)
+    {
+        perror("malloc failed");
+        return NULL;
+    }
+
+    args[0] = cmd->command;
+    for (int i = 0; i < cmd->arg_count; i++)
+    {
+        args[i + 1] = cmd->args[i];
+    }
+    args[cmd->arg_count + 1] = NULL;
+    return args;
 }
 
-// Execute built-in command with arguments
-static int execute_builtin(parsed_command_t *cmd) {
-    if (strcmp(cmd->command, "hop") == 0) {
-        char args_str[1024] = {0};
-        for (int i = 0; i < cmd->arg_count; i++) {
-            if (i > 0)
-                strcat(args_str, " ");
-            strcat(args_str, cmd->args[i]);
-        }
-        return execute_hop_direct(args_str[0] ? args_str : NULL);
+// Here-document or here-string of cmd as a sealed memfd for a spawned
+// command's stdin; -1 if it has none, -2 if it could not be made
+static int here_input_fd(const parsed_command_t *cmd)
+{
+    if (!cmd->here_doc && !cmd->here_string)
+    {
+        return -1;
     }
-    else if (strcmp(cmd->command, "reveal") == 0) {
-        char args_str[1024] = {0};
-        for (int i = 0; i < cmd->arg_count; i++) {
-            if (i > 0)
-                strcat(args_str, " ");
-            strcat(args_str, cmd->args[i]);
+    int fd = heredoc_open(cmd);
+    return fd == -1 ? -2 : fd;
+}
+
+// Process substitutions of the command being launched.  Each is a pipe:
+// the command keeps its end at the descriptor number its /dev/fd/N
+// argument names, the inner pipeline gets the other end.
+typedef struct
+{
+    int *command_fds;
+    int *inner_fds;
+    int count;
+} proc_pipes_t;
+
+// Inner processes started for the pipelines being launched.  Each launch
+// takes the entries past the mark it saw on entry, so a builtin running
+// pipelines of its own (log execute, parallel) leaves them alone.
+static pid_t *s_sub_pids = NULL;
+static int s_sub_count = 0;
+static int s_sub_capacity = 0;
+
+static pid_t execute_pipeline_command(parsed_command_t *cmd, int input_fd, int output_fd, pid_t pgid);
+static pid_t fork_builtin(const builtin_t *builtin, parsed_command_t *cmd, int input_fd, int output_fd, pid_t pgid);
+
+static void note_sub_pid(pid_t pid)
+{
+    if (s_sub_count == s_sub_capacity)
+    {
+        int capacity = s_sub_capacity ? s_sub_capacity * 2 : 8;
+        pid_t *tmp = realloc(s_sub_pids, capacity * sizeof *tmp);
+        if (!tmp)
+        {
+            // Still reaped, just not waited for
+            events_watch_quiet(pid, 0);
+            return;
         }
-        return execute_reveal(args_str[0] ? args_str : NULL);
+        s_sub_pids = tmp;
+        s_sub_capacity = capacity;
     }
-    else if (strcmp(cmd->command, "log") == 0) {
-        char args_str[1024] = {0};
-        for (int i = 0; i < cmd->arg_count; i++) {
-            if (i > 0)
-                strcat(args_str, " ");
-            strcat(args_str, cmd->args[i]);
-        }
-        return execute_log(args_str[0] ? args_str : NULL);
+    s_sub_pids[s_sub_count++] = pid;
+}
+
+// Create the pipes of cmd's process substitutions and point their
+// arguments in argv (from build_argv) at /dev/fd paths
+static int open_proc_subs(const parsed_command_t *cmd, char **argv, proc_pipes_t *subs)
+{
+    subs->count = 0;
+    if (cmd->proc_sub_count == 0)
+    {
+        return 0;
     }
-    else if (strcmp(cmd->command, "activities") == 0) {
-        return execute_activities();
+
+    subs->command_fds = arena_alloc(&g_line_arena, cmd->proc_sub_count * sizeof(int));
+    subs->inner_fds = arena_alloc(&g_line_arena, cmd->proc_sub_count * sizeof(int));
+    if (!subs->command_fds || !subs->inner_fds)
+    {
+        perror("malloc failed");
+        return -1;
     }
-    else if (strcmp(cmd->command, "ping") == 0) {
-        char args_str[1024] = {0};
-        for (int i = 0; i < cmd->arg_count; i++) {
-            if (i > 0)
-                strcat(args_str, " ");
-            strcat(args_str, cmd->args[i]);
+
+    for (int i = 0; i < cmd->proc_sub_count; i++)
+    {
+        const proc_sub_t *sub = &cmd->proc_subs[i];
+        int fds[2];
+        char *path = arena_alloc(&g_line_arena, 32);
+        if (!path || pipe2(fds, O_CLOEXEC) == -1)
+        {
+            perror("pipe failed");
+            for (int j = 0; j < subs->count; j++)
+            {
+                close(subs->command_fds[j]);
+                close(subs->inner_fds[j]);
+            }
+            subs->count = 0;
+            return -1;
         }
-        return execute_ping(args_str[0] ? args_str : NULL);
+
+        // <(...): the command reads what the pipeline writes; >(...) the
+        // other way round
+        subs->command_fds[i] = sub->is_output ? fds[1] : fds[0];
+        subs->inner_fds[i] = sub->is_output ? fds[0] : fds[1];
+        subs->count++;
+
+        snprintf(path, 32, "/dev/fd/%d", subs->command_fds[i]);
+        argv[sub->arg_index + 1] = path;
     }
-    else if (strcmp(cmd->command, "fg") == 0) {
-        char args_str[1024] = {0};
-        for (int i = 0; i < cmd->arg_count; i++) {
-            if (i > 0)
-                strcat(args_str, " ");
-            strcat(args_str, cmd->args[i]);
+    return 0;
+}
+
+// Start the stages of an inner pipeline into group pgid, with in_fd and
+// out_fd (-1: the shell's) at its two ends.  Returns the group, which the
+// first process started leads when pgid is 0.
+static pid_t start_inner_pipeline(command_pipeline_t *pipeline, int in_fd, int out_fd, pid_t pgid)
+{
+    int prev_fd = in_fd;
+    for (int i = 0; i < pipeline->cmd_count; i++)
+    {
+        int fds[2] = {-1, -1};
+        if (i < pipeline->cmd_count - 1 && pipe2(fds, O_CLOEXEC) == -1)
+        {
+            perror("pipe failed");
+            break;
         }
-        return execute_fg(args_str[0] ? args_str : NULL);
-    }
-    else if (strcmp(cmd->command, "bg") == 0) {
-        char args_str[1024] = {0};
-        for (int i = 0; i < cmd->arg_count; i++) {
-            if (i > 0)
-                strcat(args_str, " ");
-            strcat(args_str, cmd->args[i]);
+
+        parsed_command_t *cmd = &pipeline->commands[i];
+        pid_t pid = execute_pipeline_command(cmd, prev_fd, fds[1] != -1 ? fds[1] : out_fd, pgid);
+        if (pid > 0)
+        {
+            if (pgid == 0)
+                pgid = pid;
+            note_sub_pid(pid);
+            trace_launch(pid, pgid, cmd->command);
         }
-        return execute_bg(args_str[0] ? args_str : NULL);
+
+        if (i > 0)
+            close(prev_fd);
+        if (fds[1] != -1)
+            close(fds[1]);
+        prev_fd = fds[0];
+    }
+    if (prev_fd != in_fd && prev_fd != -1)
+        close(prev_fd);
+    return pgid;
+}
+
+// Run the inner pipeline of every substitution of cmd in group pgid (see
+// start_inner_pipeline), then drop the shell's copies of their ends
+static pid_t start_proc_subs(const parsed_command_t *cmd, proc_pipes_t *subs, pid_t pgid)
+{
+    for (int i = 0; i < subs->count; i++)
+    {
+        const proc_sub_t *sub = &cmd->proc_subs[i];
+        if (sub->is_output)
+            pgid = start_inner_pipeline(sub->pipeline, subs->inner_fds[i], -1, pgid);
+        else
+            pgid = start_inner_pipeline(sub->pipeline, -1, subs->inner_fds[i], pgid);
+        close(subs->inner_fds[i]);
+    }
+    return pgid;
+}
+
+// Close the command's ends once it has them (or has finished with them)
+static void close_proc_subs(proc_pipes_t *subs)
+{
+    for (int i = 0; i < subs->count; i++)
+    {
+        close(subs->command_fds[i]);
+    }
+}
+
+// A launch that failed: nothing runs on either end
+static void abandon_proc_subs(proc_pipes_t *subs)
+{
+    for (int i = 0; i < subs->count; i++)
+    {
+        close(subs->inner_fds[i]);
+    }
+    close_proc_subs(subs);
+}
+
+// Wait for the inner processes past mark that a builtin run in the shell
+// left behind; they form a foreground group of their own
+static void wait_proc_subs(int mark, pid_t pgid)
+{
+    int count = s_sub_count - mark;
+    int *statuses = count > 0 ? arena_alloc(&g_line_arena, count * sizeof(int)) : NULL;
+    if (statuses)
+    {
+        pid_t saved_pid = g_foreground_pid, saved_pgid = g_foreground_pgid;
+        g_foreground_pid = pgid;
+        g_foreground_pgid = pgid;
+        events_wait_foreground(s_sub_pids + mark, statuses, count, NULL);
+        g_foreground_pid = saved_pid;
+        g_foreground_pgid = saved_pgid;
+    }
+    s_sub_count = mark;
+}
+
+// pids[0..count) followed by the inner processes past mark, for one wait
+static pid_t *with_sub_pids(const pid_t *pids, int count, int mark, int *total)
+{
+    *total = count + s_sub_count - mark;
+    pid_t *all = arena_alloc(&g_line_arena, *total * sizeof(pid_t));
+    if (all)
+    {
+        memcpy(all, pids, count * sizeof(pid_t));
+        memcpy(all + count, s_sub_pids + mark, (s_sub_count - mark) * sizeof(pid_t));
+    }
+    return all;
+}
+
+static int has_input_redirection(const parsed_command_t *cmd)
+{
+    return cmd->input_file || cmd->here_doc || cmd->here_string;
+}
+
+// Input redirection of a builtin running in this process: < file, or the
+// memfd of a here-document or here-string
+static int redirect_builtin_input(const parsed_command_t *cmd)
+{
+    int fd = here_input_fd(cmd);
+    if (fd == -1)
+    {
+        return handle_input_redirection(cmd->input_file);
     }
-    
-    return -1;
+    if (fd == -2)
+    {
+        return -1;
+    }
+    int result = dup2(fd, STDIN_FILENO) == -1 ? -1 : 0;
+    close(fd);
+    return result;
+}
+
+// Output redirection of a builtin running in this process.  One target is
+// opened directly; several go through a relay (fanout.h) whose pid is put
+// in *relay, to be passed to finish_builtin_output once stdout no longer
+// refers to the relay's pipe.
+static int redirect_builtin_output(parsed_command_t *cmd, pid_t *relay)
+{
+    *relay = 0;
+    if (cmd->output_count <= 1)
+    {
+        return handle_output_redirection(cmd->output_file, cmd->append_mode);
+    }
+
+    fanout_t targets;
+    if (fanout_open(&targets, cmd->outputs, cmd->output_appends, cmd->output_count) != 0)
+    {
+        return -1;
+    }
+    int fd = fanout_start(&targets, relay);
+    if (fd == -1)
+    {
+        return -1;
+    }
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+    return 0;
+}
+
+// Wait until the relay has written everything out; -1 if it failed
+static int finish_builtin_output(pid_t relay)
+{
+    int status = 0;
+    if (relay > 0)
+    {
+        while (waitpid(relay, &status, 0) == -1 && errno == EINTR)
+            ;
+    }
+    return status == 0 ? 0 : -1;
+}
+
+// Run a builtin with cmd's words as its argv.  Its process substitutions
+// are started first, in group pgid (0: a group of their own), and are
+// left for the caller to wait for.
+static int execute_builtin(const builtin_t *builtin, parsed_command_t *cmd, pid_t *pgid)
+{
+    char **argv = build_argv(cmd);
+    proc_pipes_t subs;
+    if (!argv || open_proc_subs(cmd, argv, &subs) != 0)
+    {
+        return -1;
+    }
+    *pgid = start_proc_subs(cmd, &subs, *pgid);
+
+    int result = builtin->fn(cmd->arg_count + 1, argv);
+    fflush(stdout);
+    close_proc_subs(&subs);
+    return result;
+}
+
+// A fast path (fastpath.h) runs in the shell itself only if nothing it
+// reads or writes can block: the shell takes Ctrl-C from its signalfd
+// between commands, so a read waiting on a terminal or pipe, or a long
+// write to a terminal, could not be interrupted, and a write to a pipe
+// whose reader is gone would raise SIGPIPE in the shell.  Otherwise it
+// runs in a forked child.
+static int fastpath_in_shell(const parsed_command_t *cmd)
+{
+    int reads_stdin;
+    struct stat st;
+
+    if (cmd->proc_sub_count > 0 || cmd->output_count > 1 ||
+        !fastpath_inputs_regular(cmd->command, cmd->args, cmd->arg_count, &reads_stdin))
+    {
+        return 0;
+    }
+    if (cmd->output_file ? stat(cmd->output_file, &st) == 0 &&
+                               (S_ISFIFO(st.st_mode) ||
+                                (S_ISCHR(st.st_mode) && strcmp(cmd->output_file, "/dev/null") != 0))
+                         : isatty(STDOUT_FILENO) ||
+                               (fstat(STDOUT_FILENO, &st) == 0 && (S_ISFIFO(st.st_mode) || S_ISSOCK(st.st_mode))))
+    {
+        return 0;
+    }
+    if (!reads_stdin || cmd->here_doc || cmd->here_string)
+    {
+        return 1;
+    }
+    if (cmd->input_file)
+    {
+        return stat(cmd->input_file, &st) != 0 || S_ISREG(st.st_mode);
+    }
+    return fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+// Start cmd as a new foreground group with its redirections and process
+// substitutions (left in subs); -1 if it could not be started
+static pid_t launch_foreground(parsed_command_t *cmd, proc_pipes_t *subs)
+{
+    char **args = build_argv(cmd);
+    if (!args || open_proc_subs(cmd, args, subs) != 0)
+    {
+        return -1;
+    }
+
+    int here_fd = here_input_fd(cmd);
+    if (here_fd == -2)
+    {
+        abandon_proc_subs(subs);
+        return -1;
+    }
+
+    launch_spec_t spec = {
+        .argv = args,
+        .stdin_fd = here_fd,
+        .stdout_fd = -1,
+        .input_file = cmd->input_file,
+        .output_file = cmd->output_file,
+        .append_mode = cmd->append_mode,
+        .outputs = cmd->outputs,
+        .output_appends = cmd->output_appends,
+        .output_count = cmd->output_count,
+        .keep_fds = subs->command_fds,
+        .keep_count = subs->count,
+        .pgid = LAUNCH_NEW_GROUP,
+    };
+
+    pid_t pid = launch_process(&spec);
+    if (here_fd >= 0)
+    {
+        close(here_fd);
+    }
+    if (pid == -1)
+    {
+        abandon_proc_subs(subs);
+    }
+    return pid;
 }
 
 // Enhanced execute_command_with_redirection function in src/redirection.c
@@ -163,14 +487,23 @@ int execute_command_with_redirection(parsed_command_t *cmd)
         return -1;
     }
 
-    if (is_builtin_command(cmd->command))
+    // cat/head/wc with options the fast paths handle run without an exec
+    const builtin_t *builtin = builtin_lookup(cmd->command);
+    const builtin_t *fast = builtin ? NULL : fastpath_lookup(cmd->command, cmd->args, cmd->arg_count);
+    if (fast && fastpath_in_shell(cmd))
+    {
+        builtin = fast;
+        fast = NULL;
+    }
+    if (builtin)
     {
         int saved_stdin = -1, saved_stdout = -1;
+        pid_t relay = 0;
 
-        if (cmd->input_file)
+        if (has_input_redirection(cmd))
         {
             saved_stdin = dup(STDIN_FILENO);
-            if (handle_input_redirection(cmd->input_file) == -1)
+            if (redirect_builtin_input(cmd) == -1)
             {
                 if (saved_stdin != -1)
                     close(saved_stdin);
@@ -181,7 +514,7 @@ int execute_command_with_redirection(parsed_command_t *cmd)
         if (cmd->output_file)
         {
             saved_stdout = dup(STDOUT_FILENO);
-            if (handle_output_redirection(cmd->output_file, cmd->append_mode) == -1)
+            if (redirect_builtin_output(cmd, &relay) == -1)
             {
                 if (saved_stdin != -1)
                 {
@@ -194,10 +527,13 @@ int execute_command_with_redirection(parsed_command_t *cmd)
             }
         }
 
-        int result = execute_builtin(cmd);
+        int mark = s_sub_count;
+        pid_t sub_pgid = 0;
+        int result = execute_builtin(builtin, cmd, &sub_pgid);
 
         fflush(stdout);
         fflush(stderr);
+        wait_proc_subs(mark, sub_pgid);
 
         if (saved_stdin != -1)
         {
@@ -209,54 +545,29 @@ int execute_command_with_redirection(parsed_command_t *cmd)
             dup2(saved_stdout, STDOUT_FILENO);
             close(saved_stdout);
         }
+        if (finish_builtin_output(relay) != 0 && result == 0)
+        {
+            result = 1;
+        }
 
         return result;
     }
 
-    pid_t pid = fork();
-    if (pid == -1)
+    proc_pipes_t subs = {NULL, NULL, 0};
+    pid_t pid;
+    start_foreground_usage();
+    if (fast)
     {
-        perror("fork failed");
-        return -1;
+        // Its redirections and substitutions are set up in the child
+        pid = fork_builtin(fast, cmd, -1, -1, LAUNCH_NEW_GROUP);
     }
-
-    if (pid == 0)
+    else
     {
-        if (setpgid(0, 0) == -1)
-        {
-            perror("setpgid failed");
-            exit(1);
-        }
-
-        if (handle_input_redirection(cmd->input_file) == -1)
-        {
-            exit(1);
-        }
-
-        if (handle_output_redirection(cmd->output_file, cmd->append_mode) == -1)
-        {
-            exit(1);
-        }
-
-        char **args = malloc((cmd->arg_count + 2) * sizeof(char *));
-        if (!args)
-        {
-            perror("malloc failed");
-            exit(1);
-        }
-
-        args[0] = cmd->command;
-        for (int i = 0; i < cmd->arg_count; i++)
-        {
-            args[i + 1] = cmd->args[i];
-        }
-        args[cmd->arg_count + 1] = NULL;
-
-        execvp(cmd->command, args);
-
-        printf("Command not found!\n");
-        free(args);
-        exit(1);
+        pid = launch_foreground(cmd, &subs);
+    }
+    if (pid == -1)
+    {
+        return 1;
     }
     else
     {
@@ -276,46 +587,136 @@ g_foreground_command[sizeof(g_foreground_command) - 1] = '\0';
 
 
         g_foreground_command[sizeof(g_foreground_command) - 1] = '\0';
+        trace_launch(pid, pid, full_cmd);
+        trace_pgid(pid, 0, full_cmd);
+
+        // The substitutions join the command's group and are waited for
+        // with it; only the command's own status counts
+        int mark = s_sub_count;
+        close_proc_subs(&subs);
+        start_proc_subs(cmd, &subs, pid);
+        int count, status;
+        pid_t *pids = with_sub_pids(&pid, 1, mark, &count);
+        int *statuses = pids ? arena_alloc(&g_line_arena, count * sizeof(int)) : NULL;
+        s_sub_count = mark;
+        if (!statuses)
+        {
+            pids = &pid;
+            count = 1;
+            statuses = &status;
+        }
 
-        int status;
-        pid_t result;
-
-        while (1) {
-            result = waitpid(pid, &status, WUNTRACED);
-
-            if (result == -1) {
-                if (errno == EINTR) {
-                    if (g_foreground_pid == 0) {
-                        return 0;
-                    }
-                    continue;
-                } else {
-                    perror("waitpid failed");
-                    break;
-                }
-            } else if (result == pid) {
-                if (WIFSTOPPED(status)) {
-                    return 0;
-                } else {
-                    break;
-                }
-            }
+        // Ctrl-C/Ctrl-Z are forwarded by the event loop while it waits
+        int stopped = events_wait_foreground(pids, statuses, count, &s_fg_usage);
+        status = statuses[0];
+
+        g_foreground_pid = 0;
+        g_foreground_pgid = 0;
+        g_foreground_command[0] = '\0';
+
+        if (stopped)
+        {
+            s_fg_stopped = 1;
+            return 0;
+        }
+        if (status == -1)
+        {
+            return -1;
         }
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+}
+
+// Run a builtin pipeline stage in a child of its own; returns the pid
+static pid_t fork_builtin(const builtin_t *builtin, parsed_command_t *cmd, int input_fd, int output_fd, pid_t pgid)
+{
+    // Anything still buffered belongs to the shell, not to the child
+    fflush(stdout);
+    fflush(stderr);
+
+    uint64_t start = stats_now();
+    pid_t pid = fork();
+    if (pid > 0)
+        stats_since(STAT_SPAWN, start);
+    if (pid == -1)
+    {
+        perror("fork failed");
+        return -1;
+    }
 
-        if (g_foreground_pid == pid) {
-            g_foreground_pid = 0;
-            g_foreground_pgid = 0;
-            g_foreground_command[0] = '\0';
+    if (pid == 0)
+    {
+        setpgid(0, pgid);
+
+        // The shell's epoll set must not be shared; a builtin that starts
+        // processes of its own (parallel) gets a fresh loop
+        events_reset_child(STDIN_FILENO);
+
+        // The shell blocks the job-control signals for its signalfd; like
+        // a spawned command, the child takes their default actions
+        sigset_t empty;
+        sigemptyset(&empty);
+        sigprocmask(SIG_SETMASK, &empty, NULL);
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTSTP, SIG_DFL);
+
+        if (input_fd != -1 && input_fd != STDIN_FILENO)
+            dup2(input_fd, STDIN_FILENO);
+        if (output_fd != -1 && output_fd != STDOUT_FILENO)
+            dup2(output_fd, STDOUT_FILENO);
+
+        // Without an exec the pipe ends are still open here; holding the
+        // other stages' write ends would delay their readers' EOF
+        trace_close_fds(3);
+
+        pid_t relay = 0;
+        if ((has_input_redirection(cmd) && redirect_builtin_input(cmd) == -1) ||
+            (cmd->output_file && redirect_builtin_output(cmd, &relay) == -1))
+        {
+            fflush(stdout);
+            _exit(1);
         }
 
-        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        int mark = s_sub_count;
+        pid_t sub_pgid = getpgrp();
+        int result = execute_builtin(builtin, cmd, &sub_pgid);
+        fflush(stdout);
+        fflush(stderr);
+        close(STDOUT_FILENO);
+        if (finish_builtin_output(relay) != 0)
+            result = 1;
+        wait_proc_subs(mark, sub_pgid);
+        _exit(result == 0 ? 0 : 1);
     }
+
+    // Set the group from both sides so later stages can join it at once
+    setpgid(pid, pgid);
+    return pid;
 }
 
-// Execute a single command in a pipeline
-static int execute_pipeline_command(parsed_command_t *cmd, int input_fd, int output_fd, pid_t pgid)
+// Execute a single command in a pipeline.  Returns the pid to wait for,
+// or -1 if nothing was started (builtins run in the shell, failures).
+static pid_t execute_pipeline_command(parsed_command_t *cmd, int input_fd, int output_fd, pid_t pgid)
 {
-    if (is_builtin_command(cmd->command))
+    // Builtins that only read shell state run in a child of their own, so
+    // a stage such as `reveal` or `log` streams alongside the rest of the
+    // pipeline.  hop, fg, bg, log purge/execute and hash -r/name change the
+    // shell itself and keep running in the parent.
+    const builtin_t *builtin = builtin_lookup(cmd->command);
+    if (builtin && output_fd != -1 && builtin_forkable(builtin, cmd->arg_count + 1))
+    {
+        return fork_builtin(builtin, cmd, input_fd, output_fd, pgid);
+    }
+
+    // A fast path stage reads or writes a pipe, so it always gets a child
+    // (still no exec)
+    const builtin_t *fast = builtin ? NULL : fastpath_lookup(cmd->command, cmd->args, cmd->arg_count);
+    if (fast)
+    {
+        return fork_builtin(fast, cmd, input_fd, output_fd, pgid);
+    }
+
+    if (builtin)
     {
         int saved_stdin = dup(STDIN_FILENO);
         int saved_stdout = dup(STDOUT_FILENO);
@@ -330,16 +731,18 @@ static int execute_pipeline_command(parsed_command_t *cmd, int input_fd, int out
             dup2(output_fd, STDOUT_FILENO);
         }
 
-        if (cmd->input_file)
+        if (has_input_redirection(cmd))
         {
-            handle_input_redirection(cmd->input_file);
+            redirect_builtin_input(cmd);
         }
+        pid_t relay = 0;
         if (cmd->output_file)
         {
-            handle_output_redirection(cmd->output_file, cmd->append_mode);
+            redirect_builtin_output(cmd, &relay);
         }
 
-        int result = execute_builtin(cmd);
+        // Its substitutions are waited for with the pipeline
+        execute_builtin(builtin, cmd, &pgid);
 
         fflush(stdout);
         fflush(stderr);
@@ -348,96 +751,235 @@ static int execute_pipeline_command(parsed_command_t *cmd, int input_fd, int out
         dup2(saved_stdout, STDOUT_FILENO);
         close(saved_stdin);
         close(saved_stdout);
+        finish_builtin_output(relay);
 
-        return result;
+        return -1;
     }
 
-    pid_t pid = fork();
+    char **args = build_argv(cmd);
+    if (!args)
+    {
+        return -1;
+    }
+
+    proc_pipes_t subs;
+    if (open_proc_subs(cmd, args, &subs) != 0)
+    {
+        return -1;
+    }
+
+    // A here-document replaces the pipe as input, like < file does
+    int here_fd = here_input_fd(cmd);
+    if (here_fd == -2)
+    {
+        abandon_proc_subs(&subs);
+        return -1;
+    }
+
+    // Pipe ends are close-on-exec, so the child keeps only the two it needs
+    launch_spec_t spec = {
+        .argv = args,
+        .stdin_fd = here_fd >= 0 ? here_fd : input_fd,
+        .stdout_fd = output_fd,
+        .input_file = cmd->input_file,
+        .output_file = cmd->output_file,
+        .append_mode = cmd->append_mode,
+        .outputs = cmd->outputs,
+        .output_appends = cmd->output_appends,
+        .output_count = cmd->output_count,
+        .keep_fds = subs.command_fds,
+        .keep_count = subs.count,
+        .pgid = pgid,
+    };
+
+    pid_t pid = launch_process(&spec);
+    if (here_fd >= 0)
+    {
+        close(here_fd);
+    }
     if (pid == -1)
     {
-        perror("fork failed");
+        abandon_proc_subs(&subs);
         return -1;
     }
 
-    if (pid == 0)
+    // Substitutions run in the stage's group; the caller waits for them
+    close_proc_subs(&subs);
+    start_proc_subs(cmd, &subs, pgid > 0 ? pgid : pid);
+    return pid;
+}
+
+// The pipeline without its leading word (time, profile) in *out.  The
+// parse may be cached, so the first command is shifted in a copy.
+static int drop_leading_word(const command_pipeline_t *pipeline, command_pipeline_t *out)
+{
+    parsed_command_t *first = &pipeline->commands[0];
+    if (first->arg_count == 0)
+    {
+        printf("%s: usage: %s <pipeline>\n", first->command, first->command);
+        return -1;
+    }
+
+    *out = *pipeline;
+    out->commands = arena_alloc(&g_line_arena, pipeline->cmd_count * sizeof(parsed_command_t));
+    if (!out->commands)
+    {
+        perror("malloc failed");
+        return -1;
+    }
+    memcpy(out->commands, pipeline->commands, pipeline->cmd_count * sizeof(parsed_command_t));
+    out->commands[0].command = first->args[0];
+    out->commands[0].args = first->args + 1;
+    out->commands[0].arg_count = first->arg_count - 1;
+    if (first->proc_sub_count > 0)
     {
-        if (pgid == 0)
+        proc_sub_t *subs = arena_alloc(&g_line_arena, first->proc_sub_count * sizeof(proc_sub_t));
+        if (!subs)
         {
-            if (setpgid(0, 0) == -1)
-            {
-                perror("setpgid failed");
-                exit(1);
-            }
+            perror("malloc failed");
+            return -1;
         }
-        else
+        // One that became the command name is not substituted
+        int count = 0;
+        for (int i = 0; i < first->proc_sub_count; i++)
         {
-            if (setpgid(0, pgid) == -1)
+            if (first->proc_subs[i].arg_index > 0)
             {
-                perror("setpgid failed");
-                exit(1);
+                subs[count] = first->proc_subs[i];
+                subs[count++].arg_index--;
             }
         }
+        out->commands[0].proc_subs = subs;
+        out->commands[0].proc_sub_count = count;
+    }
+    return 0;
+}
 
-        if (input_fd != -1 && input_fd != STDIN_FILENO)
-        {
-            if (dup2(input_fd, STDIN_FILENO) == -1)
-            {
-                perror("dup2 failed for pipe input");
-                exit(1);
-            }
-        }
+// `time pipeline`: run the pipeline without the leading word and report
+// the resources all of its stages used, the shell's own share included
+// (builtins).  A background pipeline is accounted in activities -v instead.
+int execute_timed_pipeline(command_pipeline_t *pipeline)
+{
+    command_pipeline_t timed;
+    if (drop_leading_word(pipeline, &timed) != 0)
+    {
+        return -1;
+    }
 
-        if (output_fd != -1 && output_fd != STDOUT_FILENO)
-        {
-            if (dup2(output_fd, STDOUT_FILENO) == -1)
-            {
-                perror("dup2 failed for pipe output");
-                exit(1);
-            }
-        }
+    if (timed.is_background)
+        return execute_pipeline(&timed);
+
+    struct rusage self_before, self_after;
+    getrusage(RUSAGE_SELF, &self_before);
+
+    int outer = s_timing;
+    if (!outer)
+        usage_start(&s_fg_usage);
+    s_timing = 1;
+    int result = execute_pipeline(&timed);
+    s_timing = outer;
+
+    getrusage(RUSAGE_SELF, &self_after);
+    job_usage_t total = s_fg_usage;
+    usage_finish(&total);
+    total.user += (self_after.ru_utime.tv_sec - self_before.ru_utime.tv_sec) +
+                  (self_after.ru_utime.tv_usec - self_before.ru_utime.tv_usec) / 1e6;
+    total.sys += (self_after.ru_stime.tv_sec - self_before.ru_stime.tv_sec) +
+                 (self_after.ru_stime.tv_usec - self_before.ru_stime.tv_usec) / 1e6;
+
+    char line[160];
+    usage_format(&total, line, sizeof line);
+    fflush(stdout);
+    fprintf(stderr, "%s\n", line);
+    fflush(stderr);
+    return result;
+}
 
-        if (cmd->input_file)
-        {
-            if (handle_input_redirection(cmd->input_file) == -1)
-            {
-                exit(1);
-            }
-        }
-        if (cmd->output_file)
-        {
-            if (handle_output_redirection(cmd->output_file, cmd->append_mode) == -1)
-            {
-                exit(1);
-            }
-        }
+// `profile pipeline` (profile.h): a background pipeline runs unprofiled
+int execute_profiled_pipeline(command_pipeline_t *pipeline)
+{
+    command_pipeline_t profiled;
+    if (drop_leading_word(pipeline, &profiled) != 0)
+    {
+        return -1;
+    }
 
-        if (input_fd != -1 && input_fd != STDIN_FILENO)
-            close(input_fd);
-        if (output_fd != -1 && output_fd != STDOUT_FILENO)
-            close(output_fd);
+    s_profiling = !profiled.is_background;
+    int result = execute_pipeline(&profiled);
+    s_profiling = 0;
+    return result;
+}
 
-        char **args = malloc((cmd->arg_count + 2) * sizeof(char *));
-        if (!args)
-        {
-            perror("malloc failed");
-            exit(1);
-        }
+// `memo cmd` (memo.h).  A pipeline, a background command and a builtin
+// that changes the shell (hop, fg, ...) run as they are, uncached.
+int execute_memoized_pipeline(command_pipeline_t *pipeline)
+{
+    command_pipeline_t memoized;
+    if (drop_leading_word(pipeline, &memoized) != 0)
+    {
+        return -1;
+    }
 
-        args[0] = cmd->command;
-        for (int i = 0; i < cmd->arg_count; i++)
-        {
-            args[i + 1] = cmd->args[i];
-        }
-        args[cmd->arg_count + 1] = NULL;
+    parsed_command_t *cmd = &memoized.commands[0];
+    const builtin_t *builtin = builtin_lookup(cmd->command);
+    memo_key_t key;
+    // Nothing is kept for a command that is not found: its message is the
+    // shell's, not the command's output
+    if (memoized.cmd_count != 1 || memoized.is_background ||
+        (builtin && !builtin_forkable(builtin, cmd->arg_count + 1)) ||
+        (!builtin && !path_cache_lookup(cmd->command)) || memo_key(cmd, &key) != 0)
+    {
+        return execute_pipeline(&memoized);
+    }
 
-        execvp(cmd->command, args);
+    int status;
+    if (memo_replay(&key, cmd, &status))
+    {
+        return status;
+    }
 
-        printf("Command not found!\n");
-        free(args);
-        exit(1);
+    // stdout goes to the relay through the command's own redirection
+    // path (a > to the pipe); stderr by pointing the shell's at the other
+    int saved_stderr = dup(STDERR_FILENO);
+    if (saved_stderr == -1)
+    {
+        perror("memo");
+        return execute_command_with_redirection(cmd);
+    }
+    memo_capture_t cap;
+    if (memo_capture_start(cmd, &cap) != 0)
+    {
+        close(saved_stderr);
+        return 1;
     }
 
-    return pid;
+    // Named through the shell's own descriptor table: a forked stage
+    // closes its inherited descriptors before it opens its redirections
+    char out_path[64];
+    int truncate = 0;
+    snprintf(out_path, sizeof out_path, "/proc/%d/fd/%d", (int)getpid(), cap.out_fd);
+    parsed_command_t captured = *cmd;
+    captured.output_file = out_path;
+    captured.append_mode = 0;
+    captured.outputs = &captured.output_file;
+    captured.output_appends = &truncate;
+    captured.output_count = 1;
+
+    // Whatever the shell has buffered is not the command's output
+    fflush(stdout);
+    fflush(stderr);
+    dup2(cap.err_fd, STDERR_FILENO);
+    s_fg_stopped = 0;
+    int result = execute_command_with_redirection(&captured);
+    fflush(stdout);
+    fflush(stderr);
+    dup2(saved_stderr, STDERR_FILENO);
+    close(saved_stderr);
+
+    // A stopped command is still writing, and a killed one (-1) did not
+    // finish; neither is kept
+    memo_capture_finish(&cap, &key, result, result >= 0 && !s_fg_stopped);
+    return result;
 }
 
 // Updated execute_pipeline function without DEBUG lines
@@ -448,8 +990,17 @@ int execute_pipeline(command_pipeline_t *pipeline)
         return -1;
     }
 
-    // Single command case
-    if (pipeline->cmd_count == 1)
+    // time, profile and memo take the rest of the pipeline
+    const prefix_t *prefix = pipeline->commands[0].command ? prefix_lookup(pipeline->commands[0].command) : NULL;
+    if (prefix)
+    {
+        return prefix->fn(pipeline);
+    }
+
+    // Single command case (profiled ones go through the stage loop below)
+    int profiling = s_profiling;
+    s_profiling = 0;
+    if (pipeline->cmd_count == 1 && !profiling)
     {
         if (pipeline->is_background)
         {
@@ -463,39 +1014,36 @@ int execute_pipeline(command_pipeline_t *pipeline)
         }
     }
 
-    // Multiple commands - set up pipes
-    int **pipes = malloc((pipeline->cmd_count - 1) * sizeof(int *));
-    pid_t *pids = malloc(pipeline->cmd_count * sizeof(pid_t));
+    // Multiple commands - set up pipes (scratch lives in the line arena)
+    int (*pipes)[2] = arena_alloc(&g_line_arena, (pipeline->cmd_count - 1) * sizeof(*pipes));
+    pid_t *pids = arena_alloc(&g_line_arena, pipeline->cmd_count * sizeof(pid_t));
 
     if (!pipes || !pids)
     {
         perror("malloc failed");
-        free(pipes);
-        free(pids);
         return -1;
     }
 
     // Create all pipes
     for (int i = 0; i < pipeline->cmd_count - 1; i++)
     {
-        pipes[i] = malloc(2 * sizeof(int));
-        if (!pipes[i] || pipe(pipes[i]) == -1)
+        if (pipe2(pipes[i], O_CLOEXEC) == -1)
         {
             perror("pipe failed");
-            // Cleanup allocated pipes
+            // Close the pipes created so far
             for (int j = 0; j < i; j++)
             {
                 close(pipes[j][0]);
                 close(pipes[j][1]);
-                free(pipes[j]);
             }
-            free(pipes);
-            free(pids);
             return -1;
         }
     }
 
     pid_t pgid = 0; // Process group ID for pipeline
+    int mark = s_sub_count; // Process substitutions of the stages follow
+    if (!pipeline->is_background)
+        start_foreground_usage();
 
     // Execute each command in the pipeline
     for (int i = 0; i < pipeline->cmd_count; i++)
@@ -514,20 +1062,15 @@ int execute_pipeline(command_pipeline_t *pipeline)
             output_fd = pipes[i][1]; // Write end of current pipe
         }
 
-        // Execute the command
-        int result = execute_pipeline_command(&pipeline->commands[i], input_fd, output_fd, pgid);
-
-        if (is_builtin_command(pipeline->commands[i].command))
+        // Execute the command; builtins run in the shell have no pid
+        pids[i] = execute_pipeline_command(&pipeline->commands[i], input_fd, output_fd, pgid);
+        if (pgid == 0 && pids[i] > 0)
         {
-            pids[i] = -1; // Built-in commands don't have PIDs
+            pgid = pids[i]; // First started process sets the process group
         }
-        else
+        if (pids[i] > 0)
         {
-            pids[i] = result; // Store PID for external commands
-            if (pgid == 0)
-            {
-                pgid = pids[i]; // First external process sets the process group
-            }
+            trace_launch(pids[i], pgid, pipeline->commands[i].command);
         }
 
         // Close pipe ends in parent after forking
@@ -546,7 +1089,6 @@ int execute_pipeline(command_pipeline_t *pipeline)
 {
     close(pipes[i][0]); // Close read end of each pipe
     close(pipes[i][1]); // Close write end of each pipe (if not already closed)
-    free(pipes[i]);
 }
 
     int final_status = 0;
@@ -565,6 +1107,19 @@ int execute_pipeline(command_pipeline_t *pipeline)
                 strncat(cmd_str, " | ...", sizeof(cmd_str) - strlen(cmd_str) - 1);
             }
             add_background_job_running(pgid, cmd_str);
+
+            // The other stages and substitutions are only reaped
+            for (int i = 0; i < pipeline->cmd_count; i++)
+            {
+                if (pids[i] > 0 && pids[i] != pgid)
+                {
+                    events_watch_quiet(pids[i], pgid);
+                }
+            }
+            for (int i = mark; i < s_sub_count; i++)
+            {
+                events_watch_quiet(s_sub_pids[i], pgid);
+            }
         }
         final_status = 0;
     }
@@ -584,38 +1139,25 @@ int execute_pipeline(command_pipeline_t *pipeline)
             }
             strncpy(g_foreground_command, cmd_str, sizeof(g_foreground_command) - 1);
             g_foreground_command[sizeof(g_foreground_command) - 1] = '\0';
+            trace_pgid(pgid, 0, cmd_str);
         }
 
-        // Wait for all child processes to complete (foreground)
-        for (int i = 0; i < pipeline->cmd_count; i++)
-        {
-            if (pids[i] > 0)
-            { // Only wait for external commands
-                int status;
-                pid_t result;
-
-                while (1) {
-                    result = waitpid(pids[i], &status, WUNTRACED);
-
-                    if (result == -1) {
-                        if (errno == EINTR) {
-                            if (g_foreground_pid == 0) {
-                                break;
-                            }
-                            continue;
-                        } else {
-                            perror("waitpid failed");
-                            break;
-                        }
-                    } else if (result == pids[i]) {
-                        if (WIFSTOPPED(status)) {
-                            break;
-                        }
-                        if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
-                            final_status = WEXITSTATUS(status);
-                        }
-                        break;
-                    }
+        // Wait for all stages and substitutions to complete or the group
+        // to stop (foreground); the exit status is the stages' alone
+        int count;
+        pid_t *all = with_sub_pids(pids, pipeline->cmd_count, mark, &count);
+        int *statuses = all ? arena_alloc(&g_line_arena, count * sizeof(int)) : NULL;
+        profile_t *profile = profiling ? profile_start(pids, pipeline->commands, pipeline->cmd_count) : NULL;
+        int stopped = statuses ? events_wait_foreground(all, statuses, count, &s_fg_usage) : 0;
+        if (profiling)
+            profile_finish(profile);
+        if (statuses && !stopped)
+        {
+            for (int i = 0; i < pipeline->cmd_count; i++)
+            {
+                if (statuses[i] != -1 && WIFEXITED(statuses[i]) && WEXITSTATUS(statuses[i]) != 0)
+                {
+                    final_status = WEXITSTATUS(statuses[i]);
                 }
             }
         }
@@ -626,10 +1168,7 @@ int execute_pipeline(command_pipeline_t *pipeline)
         g_foreground_command[0] = '\0';
     }
 
-    // Cleanup
-    free(pipes);
-    free(pids);
-
+    s_sub_count = mark;
     return final_status;
 }
 
@@ -642,15 +1181,12 @@ int execute_sequential_commands(sequential_commands_t *seq_cmds)
     }
 
     int overall_status = 0;
+    const sequential_commands_t *outer = heredoc_enter(seq_cmds);
 
     // Execute each pipeline in sequence
     for (int i = 0; i < seq_cmds->pipeline_count; i++)
     {
         int status = execute_pipeline(&seq_cmds->pipelines[i]);
-        
-        // Add explicit flushing to separate stderr from stdout
-        fflush(stderr);
-        fflush(stdout);
 
         // Record if any command failed, but continue executing
         if (status != 0)
@@ -659,6 +1195,7 @@ int execute_sequential_commands(sequential_commands_t *seq_cmds)
         }
     }
 
+    heredoc_leave(outer);
     return overall_status;
 }
 
@@ -670,63 +1207,63 @@ int execute_command_background(parsed_command_t *cmd)
         return -1;
     }
 
-    if (is_builtin_command(cmd->command))
+    if (builtin_lookup(cmd->command))
     {
         printf("Built-in command '%s' cannot run in background\n", cmd->command);
         return -1;
     }
 
-    pid_t pid = fork();
-    if (pid == -1)
+    char **args = build_argv(cmd);
+    if (!args)
     {
-        perror("fork failed");
         return -1;
     }
 
-    if (pid == 0)
+    proc_pipes_t subs;
+    if (open_proc_subs(cmd, args, &subs) != 0)
     {
-        int null_fd = open("/dev/null", O_RDONLY);
-        if (null_fd != -1)
-        {
-            dup2(null_fd, STDIN_FILENO);
-            close(null_fd);
-        }
-
-        if (cmd->input_file)
-        {
-            if (handle_input_redirection(cmd->input_file) == -1)
-            {
-                exit(1);
-            }
-        }
-
-        if (cmd->output_file)
-        {
-            if (handle_output_redirection(cmd->output_file, cmd->append_mode) == -1)
-            {
-                exit(1);
-            }
-        }
-
-        char **args = malloc((cmd->arg_count + 2) * sizeof(char *));
-        if (!args)
-        {
-            perror("malloc failed");
-            exit(1);
-        }
+        return -1;
+    }
 
-        args[0] = cmd->command;
-        for (int i = 0; i < cmd->arg_count; i++)
-        {
-            args[i + 1] = cmd->args[i];
-        }
-        args[cmd->arg_count + 1] = NULL;
+    // Background jobs never read the terminal (only /dev/null or their
+    // here-document); they get their own process group so fg/ping and
+    // Ctrl-C/Ctrl-Z forwarding can address them
+    int stdin_fd = here_input_fd(cmd);
+    if (stdin_fd == -2)
+    {
+        abandon_proc_subs(&subs);
+        return -1;
+    }
+    if (stdin_fd == -1)
+    {
+        stdin_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
 
-        execvp(cmd->command, args);
+    launch_spec_t spec = {
+        .argv = args,
+        .stdin_fd = stdin_fd,
+        .stdout_fd = -1,
+        .input_file = cmd->input_file,
+        .output_file = cmd->output_file,
+        .append_mode = cmd->append_mode,
+        .outputs = cmd->outputs,
+        .output_appends = cmd->output_appends,
+        .output_count = cmd->output_count,
+        .keep_fds = subs.command_fds,
+        .keep_count = subs.count,
+        .pgid = LAUNCH_NEW_GROUP,
+    };
+
+    pid_t pid = launch_process(&spec);
+    if (stdin_fd != -1)
+    {
+        close(stdin_fd);
+    }
 
-        printf("Command not found!\n");
-        free(args);
-        exit(1);
+    if (pid == -1)
+    {
+        abandon_proc_subs(&subs);
+        return -1;
     }
     else
     {
@@ -738,7 +1275,18 @@ int execute_command_background(parsed_command_t *cmd)
             strncat(full_command, cmd->args[i], sizeof(full_command) - strlen(full_command) - 1);
         }
         
+        trace_launch(pid, pid, full_command);
         add_background_job_running(pid, full_command);
+
+        // The substitutions belong to the job: same group, only reaped
+        int mark = s_sub_count;
+        close_proc_subs(&subs);
+        start_proc_subs(cmd, &subs, pid);
+        for (int i = mark; i < s_sub_count; i++)
+        {
+            events_watch_quiet(s_sub_pids[i], pid);
+        }
+        s_sub_count = mark;
         return 0;
     }
 }
@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <string.h>
+#include "scan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCAN_HAVE_X86 1
+#endif
+
+/* ############## LLM Generated Code Begins ############## */
+
+// Classify exactly SCAN_WINDOW bytes starting at p
+typedef void (*classify_fn_t)(const char *p, uint64_t *space, uint64_t *stop);
+
+// ---------------------------------------------
+// Scalar reference: one byte at a time
+// ---------------------------------------------
+
+static int is_space_char(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Check if character is valid for a name token
+static int is_name_char(char c)
+{
+    return c != '\0' && c != '|' && c != '&' && c != '>' && c != '<' &&
+           c != ';' && !is_space_char(c);
+}
+
+static void classify_bytes(const char *p, int len, uint64_t *space, uint64_t *stop)
+{
+    uint64_t sp = 0, st = 0;
+    for (int i = 0; i < len; i++)
+    {
+        if (is_space_char(p[i]))
+            sp |= (uint64_t)1 << i;
+        if (!is_name_char(p[i]))
+            st |= (uint64_t)1 << i;
+    }
+    *space = sp;
+    *stop = st;
+}
+
+static void classify_scalar(const char *p, uint64_t *space, uint64_t *stop)
+{
+    classify_bytes(p, SCAN_WINDOW, space, stop);
+}
+
+#ifdef SCAN_HAVE_X86
+
+// ---------------------------------------------
+// SSE2: four 16-byte compares per window
+// ---------------------------------------------
+
+static void classify_sse2(const char *p, uint64_t *space, uint64_t *stop)
+{
+    uint64_t sp = 0, st = 0;
+
+    for (int i = 0; i < SCAN_WINDOW; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+        __m128i meta = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_setzero_si128()), _mm_cmpeq_epi8(v, _mm_set1_epi8('|'))),
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('&')), _mm_cmpeq_epi8(v, _mm_set1_epi8(';'))));
+        meta = _mm_or_si128(meta, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('<')),
+                                               _mm_cmpeq_epi8(v, _mm_set1_epi8('>'))));
+
+        sp |= (uint64_t)(unsigned)_mm_movemask_epi8(ws) << i;
+        st |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_or_si128(ws, meta)) << i;
+    }
+    *space = sp;
+    *stop = st;
+}
+
+// ---------------------------------------------
+// AVX2: two 32-byte compares per window
+// ---------------------------------------------
+
+__attribute__((target("avx2"))) static void classify_avx2(const char *p, uint64_t *space, uint64_t *stop)
+{
+    uint64_t sp = 0, st = 0;
+
+    for (int i = 0; i < SCAN_WINDOW; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+        __m256i meta = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('|'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('&')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(';'))));
+        meta = _mm256_or_si256(meta, _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('<')),
+                                                     _mm256_cmpeq_epi8(v, _mm256_set1_epi8('>'))));
+
+        sp |= (uint64_t)(unsigned)_mm256_movemask_epi8(ws) << i;
+        st |= (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_or_si256(ws, meta)) << i;
+    }
+    *space = sp;
+    *stop = st;
+}
+
+#endif // SCAN_HAVE_X86
+
+// ---------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------
+
+static classify_fn_t s_classify = NULL;
+static const char *s_impl_name = "scalar";
+
+static void scan_select(void)
+{
+    const char *forced = getenv("SHELL_SCAN");
+
+    s_classify = classify_scalar;
+    s_impl_name = "scalar";
+
+#ifdef SCAN_HAVE_X86
+    if (forced && strcmp(forced, "scalar") == 0)
+        return;
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && !(forced && strcmp(forced, "sse2") == 0))
+    {
+        s_classify = classify_avx2;
+        s_impl_name = "avx2";
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        s_classify = classify_sse2;
+        s_impl_name = "sse2";
+    }
+#else
+    (void)forced;
+#endif
+}
+
+const char *scan_impl_name(void)
+{
+    if (!s_classify)
+        scan_select();
+    return s_impl_name;
+}
+
+// ---------------------------------------------
+// Cursor: classify a window at p, then answer queries from its bitmaps
+// ---------------------------------------------
+
+void scan_cursor_init(scan_cursor_t *cur, const char *buf, const char *end)
+{
+    if (!s_classify)
+        scan_select();
+
+    cur->window = buf;
+    cur->end = end;
+    cur->len = 0; // Nothing classified yet
+    cur->space = 0;
+    cur->stop = 0;
+}
+
+void scan_classify_window(scan_cursor_t *cur, const char *p)
+{
+    cur->window = p;
+    if (cur->end - p >= SCAN_WINDOW)
+    {
+        cur->len = SCAN_WINDOW;
+        s_classify(p, &cur->space, &cur->stop);
+    }
+    else
+    {
+        // Tail of the line: never read past the terminator
+        cur->len = (int)(cur->end - p);
+        classify_bytes(p, cur->len, &cur->space, &cur->stop);
+    }
+}
+
+/* ############## LLM Generated Code Ends ################ */
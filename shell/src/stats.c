@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "stats.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t buckets[STATS_BUCKETS];
+} histogram_t;
+
+static histogram_t s_histograms[STAT_COUNT];
+
+static const char *const s_names[STAT_COUNT] = {
+    [STAT_PARSE] = "parse",
+    [STAT_SPAWN] = "spawn",
+    [STAT_WAIT] = "wait",
+    [STAT_REDIRECT_IN] = "redirect-in",
+    [STAT_REDIRECT_OUT] = "redirect-out",
+    [STAT_LOG_SAVE] = "log-save",
+    [STAT_PROMPT] = "prompt",
+};
+
+// Values below STATS_SUB_BUCKETS get a bucket each; above, the top
+// STATS_SUB_BITS bits after the leading one pick the bucket in its row
+static int bucket_of(uint64_t ns)
+{
+    if (ns < STATS_SUB_BUCKETS)
+        return (int)ns;
+
+    int exp = 63 - __builtin_clzll(ns);
+    if (exp > STATS_MAX_EXP)
+        return STATS_BUCKETS - 1;
+    int sub = (int)(ns >> (exp - STATS_SUB_BITS)) & (STATS_SUB_BUCKETS - 1);
+    return (exp - STATS_SUB_BITS + 1) * STATS_SUB_BUCKETS + sub;
+}
+
+// Smallest value in bucket i
+static uint64_t bucket_low(int i)
+{
+    if (i < STATS_SUB_BUCKETS)
+        return (uint64_t)i;
+
+    int exp = i / STATS_SUB_BUCKETS + STATS_SUB_BITS - 1;
+    uint64_t sub = i % STATS_SUB_BUCKETS;
+    return (STATS_SUB_BUCKETS + sub) << (exp - STATS_SUB_BITS);
+}
+
+// Middle of bucket i, the value reported for anything recorded in it
+static uint64_t bucket_value(int i)
+{
+    if (i < STATS_SUB_BUCKETS)
+        return (uint64_t)i;
+    return bucket_low(i) + (bucket_low(i + 1) - bucket_low(i)) / 2;
+}
+
+static uint64_t percentile(const histogram_t *h, double p)
+{
+    uint64_t rank = (uint64_t)(p * h->count);
+    if (rank >= h->count)
+        rank = h->count - 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < STATS_BUCKETS; i++)
+    {
+        seen += h->buckets[i];
+        if (seen > rank)
+            return bucket_value(i) < h->max ? bucket_value(i) : h->max;
+    }
+    return h->max;
+}
+
+uint64_t stats_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void stats_record(stat_id_t id, uint64_t ns)
+{
+    histogram_t *h = &s_histograms[id];
+    h->count++;
+    h->sum += ns;
+    if (ns > h->max)
+        h->max = ns;
+    h->buckets[bucket_of(ns)]++;
+}
+
+void stats_since(stat_id_t id, uint64_t start)
+{
+    stats_record(id, stats_now() - start);
+}
+
+static void print_table(void)
+{
+    printf("%-13s %8s %10s %10s %10s %10s %10s\n",
+           "metric", "count", "mean(us)", "p50(us)", "p90(us)", "p99(us)", "max(us)");
+    for (int id = 0; id < STAT_COUNT; id++)
+    {
+        const histogram_t *h = &s_histograms[id];
+        if (h->count == 0)
+        {
+            printf("%-13s %8d %10s %10s %10s %10s %10s\n", s_names[id], 0, "-", "-", "-", "-", "-");
+            continue;
+        }
+        printf("%-13s %8llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", s_names[id],
+               (unsigned long long)h->count, h->sum / 1e3 / h->count,
+               percentile(h, 0.50) / 1e3, percentile(h, 0.90) / 1e3,
+               percentile(h, 0.99) / 1e3, h->max / 1e3);
+    }
+}
+
+// One line per non-empty bucket: metric, lower bound (ns), count
+static int dump(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        printf("stats: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    fprintf(f, "# metric bucket_low_ns count\n");
+    for (int id = 0; id < STAT_COUNT; id++)
+    {
+        const histogram_t *h = &s_histograms[id];
+        for (int i = 0; i < STATS_BUCKETS; i++)
+        {
+            if (h->buckets[i])
+                fprintf(f, "%s %llu %llu\n", s_names[id],
+                        (unsigned long long)bucket_low(i), (unsigned long long)h->buckets[i]);
+        }
+    }
+
+    if (fclose(f) != 0)
+    {
+        printf("stats: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+int execute_stats(int argc, char **argv)
+{
+    if (argc == 1)
+    {
+        print_table();
+        return 0;
+    }
+    if (argc == 3 && strcmp(argv[1], "-o") == 0)
+        return dump(argv[2]);
+
+    printf("stats: usage: stats [-o file]\n");
+    return -1;
+}
+
+/* ############## LLM Generated Code Ends ################ */
@@ -0,0 +1,138 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include "trace.h"
+#include "stats.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+#define TRACE_LINE_MAX 768
+
+static int s_trace_fd = -1;
+
+void trace_init(void)
+{
+    const char *path = getenv(TRACE_ENV);
+    if (!path || !*path)
+        return;
+
+    s_trace_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (s_trace_fd == -1)
+        perror(TRACE_ENV);
+}
+
+// Append text as a JSON string (quotes included); returns the new length
+static size_t put_string(char *buf, size_t len, size_t size, const char *text)
+{
+    if (len < size)
+        buf[len++] = '"';
+    for (; *text && len + 7 < size; text++)
+    {
+        unsigned char c = (unsigned char)*text;
+        if (c == '"' || c == '\\')
+        {
+            buf[len++] = '\\';
+            buf[len++] = c;
+        }
+        else if (c < 0x20)
+        {
+            len += snprintf(buf + len, size - len, "\\u%04x", c);
+        }
+        else
+        {
+            buf[len++] = c;
+        }
+    }
+    if (len < size)
+        buf[len++] = '"';
+    return len;
+}
+
+// One event: the fixed fields, then format's (already JSON) fields, then
+// an optional "cmd" string
+static void emit(const char *event, pid_t pid, const char *command, const char *format, ...)
+{
+    char line[TRACE_LINE_MAX];
+    size_t len = snprintf(line, sizeof line, "{\"ts\":%llu,\"ev\":\"%s\",\"pid\":%d",
+                          (unsigned long long)stats_now(), event, (int)pid);
+
+    if (format)
+    {
+        va_list ap;
+        va_start(ap, format);
+        len += vsnprintf(line + len, sizeof line - len, format, ap);
+        va_end(ap);
+    }
+    if (command && len + 16 < sizeof line)
+    {
+        len += snprintf(line + len, sizeof line - len, ",\"cmd\":");
+        len = put_string(line, len, sizeof line - 3, command);
+    }
+    if (len > sizeof line - 3)
+        len = sizeof line - 3;
+    line[len++] = '}';
+    line[len++] = '\n';
+
+    if (write(s_trace_fd, line, len) == -1)
+    {
+        // A broken trace must not break the shell; stop tracing
+        close(s_trace_fd);
+        s_trace_fd = -1;
+    }
+}
+
+void trace_launch(pid_t pid, pid_t pgid, const char *command)
+{
+    if (s_trace_fd != -1)
+        emit("launch", pid, command, ",\"pgid\":%d", (int)pgid);
+}
+
+void trace_pgid(pid_t pgid, int job_id, const char *command)
+{
+    if (s_trace_fd != -1)
+        emit("pgid", pgid, command, ",\"pgid\":%d,\"job\":%d", (int)pgid, job_id);
+}
+
+void trace_stop(pid_t pid)
+{
+    if (s_trace_fd != -1)
+        emit("stop", pid, NULL, NULL);
+}
+
+void trace_continue(pid_t pid, const char *source)
+{
+    if (s_trace_fd != -1)
+        emit("continue", pid, NULL, ",\"by\":\"%s\"", source);
+}
+
+void trace_exit(pid_t pid, int status)
+{
+    if (s_trace_fd == -1)
+        return;
+
+    if (status != -1 && WIFEXITED(status))
+        emit("exit", pid, NULL, ",\"status\":%d", WEXITSTATUS(status));
+    else if (status != -1 && WIFSIGNALED(status))
+        emit("exit", pid, NULL, ",\"signal\":%d", WTERMSIG(status));
+    else
+        emit("exit", pid, NULL, NULL);
+}
+
+void trace_close_fds(unsigned int first)
+{
+    if (s_trace_fd < (int)first)
+    {
+        close_range(first, ~0U, 0);
+        return;
+    }
+    if (s_trace_fd > (int)first)
+        close_range(first, s_trace_fd - 1, 0);
+    close_range(s_trace_fd + 1, ~0U, 0);
+}
+
+/* ############## LLM Generated Code Ends ################ */
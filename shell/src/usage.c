@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "usage.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+typedef struct
+{
+    pid_t pid;
+    char command[256];
+    int status;
+    job_usage_t usage;
+} usage_record_t;
+
+// Ring of the last USAGE_HISTORY finished jobs
+static usage_record_t s_records[USAGE_HISTORY];
+static int s_record_count = 0;
+static int s_record_next = 0;
+
+static double elapsed_since(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+void usage_start(job_usage_t *u)
+{
+    memset(u, 0, sizeof *u);
+    clock_gettime(CLOCK_MONOTONIC, &u->started);
+}
+
+void usage_add(job_usage_t *u, const struct rusage *ru)
+{
+    u->user += ru->ru_utime.tv_sec + ru->ru_utime.tv_usec / 1e6;
+    u->sys += ru->ru_stime.tv_sec + ru->ru_stime.tv_usec / 1e6;
+    if (ru->ru_maxrss > u->max_rss_kb)
+        u->max_rss_kb = ru->ru_maxrss;
+    u->voluntary += ru->ru_nvcsw;
+    u->involuntary += ru->ru_nivcsw;
+    u->processes++;
+}
+
+void usage_finish(job_usage_t *u)
+{
+    u->real = elapsed_since(&u->started);
+}
+
+void usage_format(const job_usage_t *u, char *buf, size_t size)
+{
+    snprintf(buf, size, "real %.3fs user %.3fs sys %.3fs maxrss %ldKB ctxsw %ld/%ld",
+             u->real, u->user, u->sys, u->max_rss_kb, u->voluntary, u->involuntary);
+}
+
+void usage_sample(const job_usage_t *u, pid_t pid, job_usage_t *out)
+{
+    *out = *u;
+    out->real = elapsed_since(&u->started);
+
+    char path[64], buf[1024];
+    snprintf(path, sizeof path, "/proc/%d/stat", (int)pid);
+    FILE *f = fopen(path, "r");
+    if (f)
+    {
+        // utime and stime are fields 14 and 15; the command name (field 2)
+        // may contain spaces, so count from its closing parenthesis
+        unsigned long utime, stime;
+        char *p = fgets(buf, sizeof buf, f) ? strrchr(buf, ')') : NULL;
+        if (p && sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                        &utime, &stime) == 2)
+        {
+            long ticks = sysconf(_SC_CLK_TCK);
+            out->user += (double)utime / ticks;
+            out->sys += (double)stime / ticks;
+        }
+        fclose(f);
+    }
+
+    snprintf(path, sizeof path, "/proc/%d/status", (int)pid);
+    f = fopen(path, "r");
+    if (f)
+    {
+        long value;
+        while (fgets(buf, sizeof buf, f))
+        {
+            if (sscanf(buf, "VmHWM: %ld", &value) == 1 && value > out->max_rss_kb)
+                out->max_rss_kb = value;
+            else if (sscanf(buf, "voluntary_ctxt_switches: %ld", &value) == 1)
+                out->voluntary += value;
+            else if (sscanf(buf, "nonvoluntary_ctxt_switches: %ld", &value) == 1)
+                out->involuntary += value;
+        }
+        fclose(f);
+    }
+}
+
+void usage_record(pid_t pid, const char *command, int status, const job_usage_t *u)
+{
+    usage_record_t *r = &s_records[s_record_next];
+    s_record_next = (s_record_next + 1) % USAGE_HISTORY;
+    if (s_record_count < USAGE_HISTORY)
+        s_record_count++;
+
+    r->pid = pid;
+    strncpy(r->command, command, sizeof(r->command) - 1);
+    r->command[sizeof(r->command) - 1] = '\0';
+    r->status = status;
+    r->usage = *u;
+}
+
+job_usage_t *usage_find_record(pid_t pid)
+{
+    // Newest first, in case the pid was reused
+    for (int i = 1; i <= s_record_count; i++)
+    {
+        usage_record_t *r = &s_records[(s_record_next - i + USAGE_HISTORY) % USAGE_HISTORY];
+        if (r->pid == pid)
+            return &r->usage;
+    }
+    return NULL;
+}
+
+void usage_print_records(void)
+{
+    for (int i = s_record_count; i >= 1; i--)
+    {
+        const usage_record_t *r = &s_records[(s_record_next - i + USAGE_HISTORY) % USAGE_HISTORY];
+
+        char state[32], line[160];
+        if (r->status != -1 && WIFEXITED(r->status))
+            snprintf(state, sizeof state, "Exited %d", WEXITSTATUS(r->status));
+        else if (r->status != -1 && WIFSIGNALED(r->status))
+            snprintf(state, sizeof state, "Killed by signal %d", WTERMSIG(r->status));
+        else
+            snprintf(state, sizeof state, "Exited");
+
+        usage_format(&r->usage, line, sizeof line);
+        printf("[%d] : %s - %s - %s\n", r->pid, r->command, state, line);
+    }
+}
+
+/* ############## LLM Generated Code Ends ################ */
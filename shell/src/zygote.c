@@ -0,0 +1,353 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "zygote.h"
+#include "launch.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+extern char **environ;
+
+// Largest request: the header, then path, argv and the environment as
+// NUL-separated strings.  A longer one is launched with posix_spawn
+// instead.  Every string takes at least its NUL, which bounds the count.
+#define ZYGOTE_MSG_MAX 65536
+
+// The descriptors sent with a request: cwd, stdin, stdout, stderr, keeps
+#define ZYGOTE_FIXED_FDS 4
+#define ZYGOTE_MAX_FDS (ZYGOTE_FIXED_FDS + ZYGOTE_MAX_KEEP)
+
+typedef struct
+{
+    pid_t pgid;                 // 0: new group, else the group to join
+    int argc;
+    int envc;
+    int keep_count;
+    int keep[ZYGOTE_MAX_KEEP];  // Numbers the kept descriptors go to
+} zygote_request_t;
+
+typedef struct
+{
+    pid_t pid;
+    int err;                    // errno of the failed exec, or 0
+} zygote_reply_t;
+
+static int s_sock = -1;
+static pid_t s_owner = 0;       // The shell that started the helper
+static pid_t s_helper = 0;
+
+// Stack for the cloned child; it shares the helper's memory until exec
+#define ZYGOTE_STACK_SIZE (64 * 1024)
+
+typedef struct
+{
+    const zygote_request_t *req;
+    char *path;
+    char **argv;
+    char **envp;
+    const int *fds;             // As received: cwd, stdin, stdout, stderr, keeps
+    int err;                    // Set by the child if it does not exec
+} clone_args_t;
+
+// Move the received descriptors to their numbers in the new child.  They
+// are first lifted above every target so no dup2 overwrites one still
+// to be moved; the lifted copies are close-on-exec.
+static int place_fds(const int *fds, int count, const int *targets)
+{
+    int top = 2;
+    for (int i = 0; i < count; i++)
+        if (targets[i] > top)
+            top = targets[i];
+
+    int lifted[ZYGOTE_MAX_FDS];
+    for (int i = 0; i < count; i++)
+        if ((lifted[i] = fcntl(fds[i], F_DUPFD_CLOEXEC, top + 1)) == -1)
+            return -1;
+    for (int i = 0; i < count; i++)
+        if (dup2(lifted[i], targets[i]) == -1)
+            return -1;
+    return 0;
+}
+
+// The child side of clone_command, up to the exec
+static int exec_child(void *arg)
+{
+    clone_args_t *a = arg;
+    const zygote_request_t *req = a->req;
+
+    // Like posix_spawn with SETSIGMASK and SETSIGDEF in launch_process
+    sigset_t empty;
+    sigemptyset(&empty);
+    sigprocmask(SIG_SETMASK, &empty, NULL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTSTP, SIG_DFL);
+
+    int targets[ZYGOTE_MAX_FDS] = {-1, STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    for (int i = 0; i < req->keep_count; i++)
+        targets[ZYGOTE_FIXED_FDS + i] = req->keep[i];
+
+    if (setpgid(0, req->pgid) == -1 || fchdir(a->fds[0]) == -1 ||
+        place_fds(a->fds + 1, ZYGOTE_FIXED_FDS - 1 + req->keep_count, targets + 1) == -1)
+    {
+        a->err = errno;
+        _exit(127);
+    }
+    execve(a->path, a->argv, a->envp);
+    a->err = errno;
+    _exit(127);
+}
+
+// Start one command in the shell's name.  As in glibc's posix_spawn the
+// child shares the helper's memory and the helper sleeps until it has
+// exec'd, so nothing is copied and a failed exec is seen in *err.
+// CLONE_PARENT makes it the shell's child: the shell waits for it, gets
+// its SIGCHLD and may put it in a group of its own.
+static pid_t clone_command(const zygote_request_t *req, char *path, char **argv, char **envp,
+                           const int *fds, int *err)
+{
+    static char stack[ZYGOTE_STACK_SIZE] __attribute__((aligned(16)));
+
+    clone_args_t args = {req, path, argv, envp, fds, 0};
+    pid_t pid = clone(exec_child, stack + sizeof stack, CLONE_PARENT | CLONE_VM | CLONE_VFORK | SIGCHLD, &args);
+    *err = pid == -1 ? errno : args.err;
+    return pid;
+}
+
+// The helper's loop: one request in, one reply out, until the shell exits
+static void serve(int sock)
+{
+    static char msg[ZYGOTE_MSG_MAX];
+    static char *words[ZYGOTE_MSG_MAX + 2];     // argv, NULL, envp, NULL
+
+    for (;;)
+    {
+        union
+        {
+            char buf[CMSG_SPACE(ZYGOTE_MAX_FDS * sizeof(int))];
+            struct cmsghdr align;
+        } control;
+        struct iovec iov = {msg, sizeof msg - 1};
+        struct msghdr mh = {
+            .msg_iov = &iov,
+            .msg_iovlen = 1,
+            .msg_control = control.buf,
+            .msg_controllen = sizeof control.buf,
+        };
+
+        ssize_t len = recvmsg(sock, &mh, MSG_CMSG_CLOEXEC);
+        if (len == -1 && errno == EINTR)
+            continue;
+        if (len <= 0)
+            return;
+
+        int fds[ZYGOTE_MAX_FDS];
+        int nfds = 0;
+        struct cmsghdr *cm = CMSG_FIRSTHDR(&mh);
+        if (cm && cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_RIGHTS)
+        {
+            nfds = (cm->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            memcpy(fds, CMSG_DATA(cm), nfds * sizeof(int));
+        }
+
+        zygote_reply_t reply = {-1, EINVAL};
+        zygote_request_t req;
+        if ((size_t)len > sizeof req)
+        {
+            memcpy(&req, msg, sizeof req);
+            msg[len] = '\0';
+
+            // path, then argc words of argv and envc of the environment
+            char *p = msg + sizeof req;
+            char *end = msg + len;
+            char *path = p;
+            int argc = 0, envc = 0;
+            p += strlen(p) + 1;
+            while (argc < req.argc && p < end)
+            {
+                words[argc++] = p;
+                p += strlen(p) + 1;
+            }
+            words[argc] = NULL;
+            char **envp = words + argc + 1;
+            while (envc < req.envc && p < end)
+            {
+                envp[envc++] = p;
+                p += strlen(p) + 1;
+            }
+            envp[envc] = NULL;
+
+            if (argc == req.argc && argc > 0 && envc == req.envc && req.keep_count >= 0 &&
+                req.keep_count <= ZYGOTE_MAX_KEEP && nfds == ZYGOTE_FIXED_FDS + req.keep_count)
+                reply.pid = clone_command(&req, path, words, envp, fds, &reply.err);
+        }
+
+        for (int i = 0; i < nfds; i++)
+            close(fds[i]);
+        if (send(sock, &reply, sizeof reply, MSG_NOSIGNAL) != sizeof reply)
+            return;
+    }
+}
+
+void zygote_start(void)
+{
+    const char *mode = getenv(ZYGOTE_ENV);
+    if (mode && strcmp(mode, "off") == 0)
+        return;
+
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) == -1)
+        return;
+
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t shell = getpid();
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        // Out of the shell's group, so Ctrl-C and Ctrl-Z at the terminal
+        // never reach the helper; it goes when the shell does
+        setpgid(0, 0);
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        if (getppid() != shell)
+            _exit(0);
+        signal(SIGINT, SIG_IGN);
+        signal(SIGTSTP, SIG_IGN);
+
+        close(sv[0]);
+        if (sv[1] != 3)
+        {
+            dup3(sv[1], 3, O_CLOEXEC);
+            close(sv[1]);
+        }
+        close_range(4, ~0U, 0);
+        serve(3);
+        _exit(0);
+    }
+
+    close(sv[1]);
+    if (pid == -1)
+    {
+        close(sv[0]);
+        return;
+    }
+    s_sock = sv[0];
+    s_owner = shell;
+    s_helper = pid;
+}
+
+// The helper is gone or confused; launch without it from now on
+static int give_up(void)
+{
+    close(s_sock);
+    s_sock = -1;
+    kill(s_helper, SIGKILL);
+    while (waitpid(s_helper, NULL, 0) == -1 && errno == EINTR)
+        ;
+    return ZYGOTE_UNAVAILABLE;
+}
+
+int zygote_spawn(pid_t *pid, const char *path, char *const argv[], const int fds[3],
+                 const int *keep_fds, int keep_count, pid_t pgid)
+{
+    if (s_sock == -1 || getpid() != s_owner || keep_count > ZYGOTE_MAX_KEEP)
+        return ZYGOTE_UNAVAILABLE;
+
+    static char msg[ZYGOTE_MSG_MAX];
+    zygote_request_t req = {0};
+    req.pgid = pgid == LAUNCH_SAME_GROUP ? getpgrp() : pgid;
+    req.keep_count = keep_count;
+    for (int i = 0; i < keep_count; i++)
+        req.keep[i] = keep_fds[i];
+
+    size_t len = sizeof req;
+    size_t n = strlen(path) + 1;
+    if (len + n > sizeof msg)
+        return ZYGOTE_UNAVAILABLE;
+    memcpy(msg + len, path, n);
+    len += n;
+    for (; argv[req.argc]; req.argc++)
+    {
+        n = strlen(argv[req.argc]) + 1;
+        if (len + n > sizeof msg - 1)
+            return ZYGOTE_UNAVAILABLE;
+        memcpy(msg + len, argv[req.argc], n);
+        len += n;
+    }
+
+    // The shell's environment as it is now, not as the helper copied it
+    for (; environ[req.envc]; req.envc++)
+    {
+        n = strlen(environ[req.envc]) + 1;
+        if (len + n > sizeof msg - 1)
+            return ZYGOTE_UNAVAILABLE;
+        memcpy(msg + len, environ[req.envc], n);
+        len += n;
+    }
+    memcpy(msg, &req, sizeof req);
+
+    // The child starts in the shell's current directory, whatever hop did
+    int cwd = open(".", O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (cwd == -1)
+        return ZYGOTE_UNAVAILABLE;
+
+    int send_fds[ZYGOTE_MAX_FDS] = {cwd, fds[0], fds[1], fds[2]};
+    for (int i = 0; i < keep_count; i++)
+        send_fds[ZYGOTE_FIXED_FDS + i] = keep_fds[i];
+    int nfds = ZYGOTE_FIXED_FDS + keep_count;
+
+    union
+    {
+        char buf[CMSG_SPACE(ZYGOTE_MAX_FDS * sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof control);
+    struct iovec iov = {msg, len};
+    struct msghdr mh = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control.buf,
+        .msg_controllen = CMSG_SPACE(nfds * sizeof(int)),
+    };
+    struct cmsghdr *cm = CMSG_FIRSTHDR(&mh);
+    cm->cmsg_level = SOL_SOCKET;
+    cm->cmsg_type = SCM_RIGHTS;
+    cm->cmsg_len = CMSG_LEN(nfds * sizeof(int));
+    memcpy(CMSG_DATA(cm), send_fds, nfds * sizeof(int));
+
+    ssize_t sent;
+    while ((sent = sendmsg(s_sock, &mh, MSG_NOSIGNAL)) == -1 && errno == EINTR)
+        ;
+    close(cwd);
+    if (sent != (ssize_t)len)
+        return give_up();
+
+    zygote_reply_t reply;
+    ssize_t got;
+    while ((got = recv(s_sock, &reply, sizeof reply, 0)) == -1 && errno == EINTR)
+        ;
+    if (got != sizeof reply)
+        return give_up();
+
+    if (reply.pid > 0 && reply.err != 0)
+    {
+        // The child that failed to exec is ours to reap
+        while (waitpid(reply.pid, NULL, 0) == -1 && errno == EINTR)
+            ;
+    }
+    if (reply.pid <= 0 && reply.err == 0)
+        reply.err = EAGAIN;
+    *pid = reply.pid;
+    return reply.err;
+}
+
+/* ############## LLM Generated Code Ends ################ */
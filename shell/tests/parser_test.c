@@ -0,0 +1,187 @@
+// Parser checks: drives the front end directly (no processes are launched)
+// over lines whose parse is known, and fails if any is accepted, rejected
+// or split differently than expected.
+#include <stdio.h>
+#include <string.h>
+#include "parser.h"
+
+/* ############## LLM Generated Code Begins ############## */
+
+static int failures = 0;
+
+static void check(int ok, const char *line, const char *what)
+{
+    if (!ok)
+    {
+        printf("FAIL: %s: %s\n", line, what);
+        failures++;
+    }
+}
+
+// line parses as one command whose args are exactly args (NULL-ended)
+static void expect_args(arena_t *arena, const char *line, const char *command, const char **args)
+{
+    parsed_command_t cmd;
+    if (parse_command_with_redirection(line, &cmd, arena) != 0)
+    {
+        check(0, line, "rejected");
+        arena_reset(arena);
+        return;
+    }
+
+    check(strcmp(cmd.command, command) == 0, line, "wrong command");
+    int count = 0;
+    while (args[count])
+        count++;
+    check(cmd.arg_count == count, line, "wrong argument count");
+    for (int i = 0; i < count && i < cmd.arg_count; i++)
+        check(strcmp(cmd.args[i], args[i]) == 0, line, "wrong argument");
+    arena_reset(arena);
+}
+
+// parse_command_with_redirection stops at the first token it cannot use,
+// so the verdict on a whole line is parse_command's
+static void expect_invalid(const char *line)
+{
+    check(parse_command(line) != 0, line, "accepted");
+}
+
+// Shape of a whole line: its pipelines, their sizes and & flags, in order
+static void expect_sequence(arena_t *arena, const char *line, int count,
+                            const int *cmd_counts, const int *background)
+{
+    sequential_commands_t seq;
+    if (parse_sequential_commands(line, &seq, arena) != 0)
+    {
+        check(0, line, "rejected");
+        arena_reset(arena);
+        return;
+    }
+
+    check(seq.pipeline_count == count, line, "wrong pipeline count");
+    for (int i = 0; i < count && i < seq.pipeline_count; i++)
+    {
+        check(seq.pipelines[i].cmd_count == cmd_counts[i], line, "wrong pipeline length");
+        check(seq.pipelines[i].is_background == background[i], line, "wrong & flag");
+    }
+    arena_reset(arena);
+}
+
+static void test_sequences(arena_t *arena)
+{
+    const int two[] = {1, 1}, fg_fg[] = {0, 0};
+    expect_sequence(arena, "a ; b", 2, two, fg_fg);
+
+    const int bg_fg[] = {1, 0}, fg_bg[] = {0, 1};
+    expect_sequence(arena, "a & b", 2, two, bg_fg);
+    expect_sequence(arena, "a ; b &", 2, two, fg_bg);
+
+    const int one[] = {1}, bg[] = {1};
+    expect_sequence(arena, "sleep 1 &", 1, one, bg);
+
+    const int pipe_then_one[] = {2, 1};
+    expect_sequence(arena, "a | b ; c", 2, pipe_then_one, fg_fg);
+}
+
+static void test_redirections(arena_t *arena)
+{
+    parsed_command_t cmd;
+    const char *line = "cat < in > out";
+    check(parse_command_with_redirection(line, &cmd, arena) == 0 &&
+              cmd.input_file && strcmp(cmd.input_file, "in") == 0 &&
+              cmd.output_file && strcmp(cmd.output_file, "out") == 0 &&
+              !cmd.append_mode && cmd.arg_count == 0,
+          line, "wrong redirections");
+    arena_reset(arena);
+
+    // Every output is opened in order; the last one gets the output
+    line = "cat > a >> b";
+    check(parse_command_with_redirection(line, &cmd, arena) == 0 &&
+              cmd.output_count == 2 &&
+              strcmp(cmd.outputs[0], "a") == 0 && !cmd.output_appends[0] &&
+              strcmp(cmd.outputs[1], "b") == 0 && cmd.output_appends[1] &&
+              strcmp(cmd.output_file, "b") == 0 && cmd.append_mode,
+          line, "wrong output order");
+    arena_reset(arena);
+
+    const char *word_after[] = {"x", NULL};
+    expect_args(arena, "cat > out x", "cat", word_after);
+}
+
+static void test_quoting(arena_t *arena)
+{
+    const char *quoted[] = {"a|b", "c;d", "e&f", "<g>", NULL};
+    expect_args(arena, "cat \"a|b\" \"c;d\" \"e&f\" \"<g>\"", "cat", quoted);
+
+    const int one[] = {1}, fg[] = {0};
+    expect_sequence(arena, "echo \"a ; b | c &\"", 1, one, fg);
+}
+
+static void test_invalid(void)
+{
+    expect_invalid("| a");
+    expect_invalid("a |");
+    expect_invalid("a ; ; b");
+    expect_invalid(";");
+    expect_invalid("a ;");
+    expect_invalid("&");
+    expect_invalid("a & ;");
+    expect_invalid("a &&");
+    expect_invalid("a || b");
+    expect_invalid("cat >");
+    expect_invalid("cat <");
+    expect_invalid("< in cat");
+}
+
+static void test_proc_subs(arena_t *arena)
+{
+    const char *sub_then_word[] = {"<(ls)", "x", NULL};
+    expect_args(arena, "cmd <(ls) x", "cmd", sub_then_word);
+
+    const char *two_subs[] = {"<(sort a)", ">(wc -l)", NULL};
+    expect_args(arena, "diff <(sort a) >(wc -l)", "diff", two_subs);
+
+    parsed_command_t cmd;
+    const char *line = "cat <(ls)>out";
+    check(parse_command_with_redirection(line, &cmd, arena) == 0 &&
+              cmd.arg_count == 1 && strcmp(cmd.args[0], "<(ls)") == 0 &&
+              cmd.output_file && strcmp(cmd.output_file, "out") == 0,
+          line, "operator after ) not split off");
+    arena_reset(arena);
+
+    command_pipeline_t pipeline;
+    line = "cat <(ls)|wc";
+    check(parse_pipeline(line, &pipeline, arena) == 0 && pipeline.cmd_count == 2,
+          line, "pipe after ) not split off");
+    arena_reset(arena);
+
+    // Text glued to the closing ) would lose its first byte
+    expect_invalid("cmd <(ls)x");
+    expect_invalid("cmd >(wc)abc");
+    expect_invalid("cmd <(ls))");
+    expect_invalid("cmd <(ls");
+}
+
+int main(void)
+{
+    arena_t arena;
+    arena_init(&arena);
+
+    test_sequences(&arena);
+    test_redirections(&arena);
+    test_quoting(&arena);
+    test_invalid();
+    test_proc_subs(&arena);
+
+    arena_destroy(&arena);
+
+    if (failures)
+    {
+        printf("%d parser check(s) failed\n", failures);
+        return 1;
+    }
+    printf("parser checks passed\n");
+    return 0;
+}
+
+/* ############## LLM Generated Code Ends ################ */
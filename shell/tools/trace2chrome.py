@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# ############## LLM Generated Code Begins ##############
+"""Convert a SHELL_TRACE job trace (JSON lines) to Chrome trace format.
+
+    SHELL_TRACE=/tmp/jobs.trace ./shell.out -s script
+    tools/trace2chrome.py /tmp/jobs.trace > jobs.json
+
+Open jobs.json in chrome://tracing or https://ui.perfetto.dev.  Each
+process group is one row group (named after its job), each process one
+row with a slice from launch to exit; stopped periods are slices of
+their own and continues are marked with who sent them.
+"""
+
+import json
+import sys
+
+
+def load(path):
+    events = []
+    with open(path) as f:
+        for n, line in enumerate(f, 1):
+            line = line.strip()
+            if not line:
+                continue
+            try:
+                events.append(json.loads(line))
+            except ValueError:
+                sys.stderr.write("%s:%d: skipping malformed line\n" % (path, n))
+    events.sort(key=lambda e: e["ts"])
+    return events
+
+
+def convert(events):
+    if not events:
+        return {"traceEvents": []}
+
+    origin = events[0]["ts"]
+    end = events[-1]["ts"]
+
+    def us(ts):
+        return (ts - origin) / 1000.0
+
+    out = []
+    group_of = {}       # pid -> pgid
+    launched = {}       # pid -> launch event
+    stopped = {}        # pid -> stop ts
+    named = set()
+
+    def slice_(name, cat, pid, start, stop, args=None):
+        out.append({"name": name, "cat": cat, "ph": "X",
+                    "pid": group_of.get(pid, pid), "tid": pid,
+                    "ts": us(start), "dur": max(us(stop) - us(start), 0.001),
+                    "args": args or {}})
+
+    for e in events:
+        pid = e["pid"]
+        kind = e["ev"]
+        if kind == "launch":
+            group_of[pid] = e.get("pgid", pid)
+            launched[pid] = e
+            out.append({"name": "thread_name", "ph": "M", "pid": group_of[pid],
+                        "tid": pid, "args": {"name": "%s (%d)" % (e.get("cmd", "?"), pid)}})
+        elif kind == "pgid":
+            pgid = e["pgid"]
+            job = e.get("job", 0)
+            label = "job %d" % job if job else "foreground"
+            # A group is named after its first registration; a stopped
+            # foreground group later turning into a job is renamed
+            if pgid not in named or job:
+                named.add(pgid)
+                out.append({"name": "process_name", "ph": "M", "pid": pgid,
+                            "args": {"name": "%s: %s" % (label, e.get("cmd", "?"))}})
+        elif kind == "stop":
+            stopped[pid] = e["ts"]
+        elif kind == "continue":
+            if pid in stopped:
+                slice_("stopped", "stop", pid, stopped.pop(pid), e["ts"])
+            out.append({"name": "continue (%s)" % e.get("by", "?"), "cat": "signal",
+                        "ph": "i", "s": "t", "pid": group_of.get(pid, pid), "tid": pid,
+                        "ts": us(e["ts"])})
+        elif kind == "exit":
+            if pid in stopped:
+                slice_("stopped", "stop", pid, stopped.pop(pid), e["ts"])
+            start = launched.pop(pid, None)
+            if start is None:
+                continue
+            args = {k: e[k] for k in ("status", "signal") if k in e}
+            slice_(start.get("cmd", "?"), "process", pid, start["ts"], e["ts"], args)
+
+    # Still running (or stopped) when the trace ended
+    for pid, start in launched.items():
+        slice_(start.get("cmd", "?"), "process", pid, start["ts"], end, {"unfinished": True})
+    for pid, ts in stopped.items():
+        slice_("stopped", "stop", pid, ts, end)
+
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main(argv):
+    if len(argv) != 2:
+        sys.stderr.write("usage: %s trace.jsonl > trace.json\n" % argv[0])
+        return 2
+    json.dump(convert(load(argv[1])), sys.stdout)
+    sys.stdout.write("\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
+# ############## LLM Generated Code Ends ################